@@ -0,0 +1,222 @@
+#pragma once
+
+// Heap allocation counter used by the frame profiler to check that steady
+// state frames don't allocate, and a per-subsystem tally of what the process
+// has allocated.
+//
+// Every global operator new made on a thread bumps that thread's counter. It
+// is also charged to the calling thread's current AllocTag, set for a scope
+// with PROFILE_ALLOC_TAG() (profiler.h); each block carries a small header
+// with its size and tag, so the delete is charged back to whoever allocated
+// it. Untagged work counts as OTHER. Memory raylib, SDL and other C code get
+// from malloc() directly never passes through here; GetMallocHeapBytes() sees
+// the whole heap where the C library can report it.
+//
+// The replacement operators live in exactly one translation unit: define
+// GAME_ALLOC_COUNTER_IMPLEMENTATION before the first include there (main.cpp
+// and bench.cpp do). profiler.h pulls this header in only when GAME_PROFILER
+// is on, so release builds keep the standard allocator.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#if defined(__GLIBC__)
+#include <malloc.h> // For mallinfo2
+#endif
+
+// Subsystem an allocation is charged to
+enum class AllocTag : uint8_t {
+    OTHER,
+    UI,
+    AUDIO,
+    SAVE,
+    ASSETS,
+    ENTITIES,
+    COUNT
+};
+
+inline const char* GetAllocTagName(AllocTag tag) {
+    switch (tag) {
+        case AllocTag::OTHER: return "Other";
+        case AllocTag::UI: return "UI";
+        case AllocTag::AUDIO: return "Audio";
+        case AllocTag::SAVE: return "Save";
+        case AllocTag::ASSETS: return "Assets";
+        case AllocTag::ENTITIES: return "Entities";
+        default: return "?";
+    }
+}
+
+struct AllocTagStats {
+    uint64_t allocations = 0; // Since startup
+    uint64_t frees = 0;
+    int64_t liveBytes = 0;    // Requested sizes, without the tracking headers
+    int64_t peakBytes = 0;
+};
+
+namespace alloc_counter_detail {
+inline thread_local uint64_t threadAllocations = 0;
+inline thread_local AllocTag threadTag = AllocTag::OTHER;
+
+struct TagCounters {
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> frees{0};
+    std::atomic<int64_t> liveBytes{0};
+    std::atomic<int64_t> peakBytes{0};
+};
+
+// Index COUNT holds the whole process, so its peak is a real peak rather than a sum of per-tag ones
+inline TagCounters tagCounters[(int)AllocTag::COUNT + 1];
+} // namespace alloc_counter_detail
+
+// Allocations made by the calling thread since it started
+inline uint64_t GetThreadAllocationCount() { return alloc_counter_detail::threadAllocations; }
+
+// Process-wide totals for one tag; AllocTag::COUNT gives every tag together.
+// The fields are read one at a time, so under concurrent allocation they can be a moment apart.
+inline AllocTagStats GetAllocTagStats(AllocTag tag) {
+    const alloc_counter_detail::TagCounters& counters = alloc_counter_detail::tagCounters[(int)tag];
+    AllocTagStats stats;
+    stats.allocations = counters.allocations.load(std::memory_order_relaxed);
+    stats.frees = counters.frees.load(std::memory_order_relaxed);
+    stats.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+    stats.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// Bytes the C allocator has handed out, whoever asked (operator new included); -1 where it can't tell
+inline int64_t GetMallocHeapBytes() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 info = mallinfo2();
+    return (int64_t)(info.uordblks + info.hblkhd);
+#else
+    return -1;
+#endif
+}
+
+// Charges the calling thread's allocations to tag until the scope ends; nests
+class AllocTagScope {
+public:
+    explicit AllocTagScope(AllocTag tag) : previous(alloc_counter_detail::threadTag) {
+        alloc_counter_detail::threadTag = tag;
+    }
+    ~AllocTagScope() { alloc_counter_detail::threadTag = previous; }
+
+    AllocTagScope(const AllocTagScope&) = delete;
+    AllocTagScope& operator=(const AllocTagScope&) = delete;
+
+private:
+    AllocTag previous;
+};
+
+#ifdef GAME_ALLOC_COUNTER_IMPLEMENTATION
+
+#include <cstdlib>
+#include <new>
+
+namespace alloc_counter_detail {
+
+// Sits right before every block handed out; one max_align_t long, so plain
+// blocks keep malloc's alignment
+struct alignas(std::max_align_t) BlockHeader {
+    uint64_t size;
+    AllocTag tag;
+};
+
+constexpr std::size_t HEADER_SIZE = sizeof(BlockHeader);
+
+inline void UpdatePeak(TagCounters& counters, int64_t live) {
+    int64_t peak = counters.peakBytes.load(std::memory_order_relaxed);
+    while (live > peak && !counters.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+}
+
+inline void Charge(TagCounters& counters, int64_t size) {
+    counters.allocations.fetch_add(1, std::memory_order_relaxed);
+    UpdatePeak(counters, counters.liveBytes.fetch_add(size, std::memory_order_relaxed) + size);
+}
+
+// Stamps the header in front of user and charges it to the thread's tag
+inline void* Track(void* user, std::size_t size) {
+    threadAllocations++;
+    BlockHeader* header = (BlockHeader*)((char*)user - HEADER_SIZE);
+    header->size = size;
+    header->tag = threadTag;
+    Charge(tagCounters[(int)threadTag], (int64_t)size);
+    Charge(tagCounters[(int)AllocTag::COUNT], (int64_t)size);
+    return user;
+}
+
+inline void Refund(TagCounters& counters, int64_t size) {
+    counters.frees.fetch_add(1, std::memory_order_relaxed);
+    counters.liveBytes.fetch_sub(size, std::memory_order_relaxed);
+}
+
+inline void Untrack(void* user) {
+    const BlockHeader* header = (const BlockHeader*)((char*)user - HEADER_SIZE);
+    Refund(tagCounters[(int)header->tag], (int64_t)header->size);
+    Refund(tagCounters[(int)AllocTag::COUNT], (int64_t)header->size);
+}
+
+inline void* CountedAlloc(std::size_t size) {
+    while (true) {
+        if (void* p = std::malloc(HEADER_SIZE + size)) return Track((char*)p + HEADER_SIZE, size);
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+// The header takes a whole alignment unit (at least HEADER_SIZE) so the block after it stays aligned
+inline std::size_t AlignedOffset(std::align_val_t align) {
+    std::size_t alignment = (std::size_t)align;
+    return alignment > HEADER_SIZE ? alignment : HEADER_SIZE;
+}
+
+inline void* CountedAlignedAlloc(std::size_t size, std::align_val_t align) {
+    std::size_t alignment = (std::size_t)align;
+    std::size_t offset = AlignedOffset(align);
+    // aligned_alloc wants a size that is a multiple of the alignment
+    std::size_t total = (offset + size + alignment - 1) / alignment * alignment;
+    while (true) {
+        if (void* p = std::aligned_alloc(alignment, total)) return Track((char*)p + offset, size);
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+inline void CountedFree(void* p) {
+    if (!p) return;
+    Untrack(p);
+    std::free((char*)p - HEADER_SIZE);
+}
+
+inline void CountedAlignedFree(void* p, std::align_val_t align) {
+    if (!p) return;
+    Untrack(p);
+    std::free((char*)p - AlignedOffset(align));
+}
+
+} // namespace alloc_counter_detail
+
+void* operator new(std::size_t size) { return alloc_counter_detail::CountedAlloc(size); }
+void* operator new[](std::size_t size) { return alloc_counter_detail::CountedAlloc(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try { return alloc_counter_detail::CountedAlloc(size); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try { return alloc_counter_detail::CountedAlloc(size); } catch (...) { return nullptr; }
+}
+void* operator new(std::size_t size, std::align_val_t align) { return alloc_counter_detail::CountedAlignedAlloc(size, align); }
+void* operator new[](std::size_t size, std::align_val_t align) { return alloc_counter_detail::CountedAlignedAlloc(size, align); }
+
+void operator delete(void* p) noexcept { alloc_counter_detail::CountedFree(p); }
+void operator delete[](void* p) noexcept { alloc_counter_detail::CountedFree(p); }
+void operator delete(void* p, std::size_t) noexcept { alloc_counter_detail::CountedFree(p); }
+void operator delete[](void* p, std::size_t) noexcept { alloc_counter_detail::CountedFree(p); }
+void operator delete(void* p, std::align_val_t align) noexcept { alloc_counter_detail::CountedAlignedFree(p, align); }
+void operator delete[](void* p, std::align_val_t align) noexcept { alloc_counter_detail::CountedAlignedFree(p, align); }
+void operator delete(void* p, std::size_t, std::align_val_t align) noexcept { alloc_counter_detail::CountedAlignedFree(p, align); }
+void operator delete[](void* p, std::size_t, std::align_val_t align) noexcept { alloc_counter_detail::CountedAlignedFree(p, align); }
+
+#endif
@@ -0,0 +1,388 @@
+#pragma once
+
+#include "raylib.h"
+#include "profiler.h"
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <libgen.h> // For dirname
+#include <unistd.h> // For readlink
+
+// Directory holding the running executable, without a trailing slash; "." if
+// it can't be determined
+inline std::string GetExecutableDir() {
+    static const std::string dir = [] {
+        char exePath[4096];
+        ssize_t len = readlink("/proc/self/exe", exePath, sizeof(exePath) - 1);
+        if (len == -1) return std::string(".");
+        exePath[len] = '\0';
+        return std::string(dirname(exePath));
+    }();
+    return dir;
+}
+
+// Relative paths are taken relative to the executable, so the game finds its
+// files whatever the working directory
+inline std::string ResolveAssetPath(const std::string& path) {
+    if (path.empty() || path[0] == '/') return path;
+    return GetExecutableDir() + "/" + path;
+}
+
+// Refers to one cached asset. Stays valid (and keeps the asset loaded) until
+// it is passed to AssetManager::Release(); a released slot gets a new
+// generation, so a stale handle reads as the placeholder, never as another asset.
+struct AssetHandle {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool IsNull() const { return index == UINT32_MAX; }
+};
+
+enum class AssetState {
+    LOADING, // Queued or decoding; Get*() returns the placeholder
+    READY,
+    FAILED   // Missing or unreadable; Get*() keeps returning the placeholder
+};
+
+// Loads textures, sounds and fonts without blocking the frame.
+//
+// Request*() returns at once. Files are read and decoded (image pixels, audio
+// samples, font glyphs and atlas) on LOADER_THREADS background threads; the
+// parts raylib needs the main thread for (GPU textures, audio buffers) are
+// done by Update() over as many frames as its time budget needs. Until an
+// asset is ready its handle gives a placeholder: a blank texture, a silent
+// sound or raylib's default font, all safe to draw or play.
+//
+// Assets are cached by path (and size, for fonts); requesting one again adds a
+// reference to the same entry. Release() drops a reference and unloads the
+// asset when the last one goes. Everything except the decoding runs on the
+// thread that calls Update().
+class AssetManager {
+public:
+    static constexpr int LOADER_THREADS = 2;
+    static constexpr int DEFAULT_FONT_SIZE = 32;
+
+    ~AssetManager() { Stop(); }
+
+    void Start() {
+        if (!loaders.empty()) return;
+        stopRequested = false;
+        for (int i = 0; i < LOADER_THREADS; i++) loaders.emplace_back(&AssetManager::LoaderMain, this);
+    }
+
+    // Joins the loaders; call UnloadAll() afterwards, while the window and audio device are still open
+    void Stop() {
+        if (loaders.empty()) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopRequested = true;
+        }
+        wake.notify_all();
+        for (std::thread& loader : loaders) loader.join();
+        loaders.clear();
+    }
+
+    AssetHandle RequestTexture(const std::string& path) { return Request(AssetType::TEXTURE, path, 0); }
+    AssetHandle RequestSound(const std::string& path) { return Request(AssetType::SOUND, path, 0); }
+    AssetHandle RequestFont(const std::string& path, int fontSize = DEFAULT_FONT_SIZE) {
+        return Request(AssetType::FONT, path, fontSize);
+    }
+
+    // Adds a reference, for a second owner of the same handle
+    void Retain(AssetHandle handle) {
+        if (Entry* entry = Find(handle)) entry->refCount++;
+    }
+
+    // Drops a reference; the last one unloads the asset (or discards it once decoded)
+    void Release(AssetHandle handle) {
+        Entry* entry = Find(handle);
+        if (!entry || --entry->refCount > 0) return;
+        if (entry->state == AssetState::READY) UnloadEntry(*entry);
+        if (entry->state == AssetState::LOADING) pendingCount--;
+        cacheIndex.erase(entry->key);
+        entry->key.clear();
+        entry->state = AssetState::FAILED;
+        entry->generation++; // A decode still in flight for this slot is now stale
+        freeSlots.push_back(handle.index);
+    }
+
+    AssetState GetState(AssetHandle handle) const {
+        const Entry* entry = Find(handle);
+        return entry ? entry->state : AssetState::FAILED;
+    }
+
+    bool IsReady(AssetHandle handle) const { return GetState(handle) == AssetState::READY; }
+
+    // Blank (id 0) texture until ready; DrawTexture*() skips it
+    Texture2D GetTexture(AssetHandle handle) const {
+        const Entry* entry = Find(handle);
+        return entry && entry->state == AssetState::READY ? entry->texture : Texture2D{};
+    }
+
+    // Silent sound until ready; PlaySound() ignores it
+    Sound GetSound(AssetHandle handle) const {
+        const Entry* entry = Find(handle);
+        return entry && entry->state == AssetState::READY ? entry->sound : Sound{};
+    }
+
+    // raylib's default font until ready
+    Font GetFont(AssetHandle handle) const {
+        const Entry* entry = Find(handle);
+        return entry && entry->state == AssetState::READY ? entry->font : GetFontDefault();
+    }
+
+    // Requests still loading, including ones waiting for Update()
+    int GetPendingCount() const { return pendingCount; }
+
+    // Main thread, once per frame: finishes decoded assets until budgetMs is
+    // spent. At least one is finished per call, so a budget of 0 still makes progress.
+    void Update(double budgetMs) {
+        PROFILE_ALLOC_TAG(AllocTag::ASSETS);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            while (!decoded.empty()) {
+                uploads.push_back(std::move(decoded.front()));
+                decoded.pop_front();
+            }
+        }
+        double start = GetTime();
+        while (!uploads.empty()) {
+            std::unique_ptr<DecodeJob> job = std::move(uploads.front());
+            uploads.pop_front();
+            Finish(*job);
+            if ((GetTime() - start) * 1000.0 >= budgetMs) break;
+        }
+    }
+
+    // Unloads every asset regardless of references; the loaders must be stopped
+    void UnloadAll() {
+        for (Entry& entry : entries) {
+            if (entry.state == AssetState::READY) UnloadEntry(entry);
+            entry.state = AssetState::FAILED;
+            entry.generation++;
+        }
+        for (auto& job : uploads) DiscardDecoded(*job);
+        uploads.clear();
+        for (auto& job : queued) DiscardDecoded(*job);
+        queued.clear();
+        for (auto& job : decoded) DiscardDecoded(*job);
+        decoded.clear();
+        cacheIndex.clear();
+        pendingCount = 0;
+    }
+
+private:
+    enum class AssetType { TEXTURE, SOUND, FONT };
+
+    struct Entry {
+        std::string key; // Cache key; empty while the slot is free
+        AssetType type = AssetType::TEXTURE;
+        AssetState state = AssetState::FAILED;
+        uint32_t generation = 0;
+        int refCount = 0;
+        Texture2D texture = {};
+        Sound sound = {};
+        Font font = {};
+    };
+
+    // Owned by one thread at a time: the main thread, then a loader, then the main thread again
+    struct DecodeJob {
+        uint32_t index;
+        uint32_t generation;
+        AssetType type;
+        std::string path; // Already resolved
+        int fontSize = 0;
+        bool ok = false;
+        Image image = {};            // Textures, and the atlas for fonts
+        Wave wave = {};              // Sounds
+        GlyphInfo* glyphs = nullptr; // Fonts
+        Rectangle* glyphRecs = nullptr;
+        int glyphCount = 0;
+    };
+
+    static constexpr int FONT_GLYPHS = 95; // Printable ASCII, as raylib's LoadFont
+    static constexpr int FONT_PADDING = 4;
+
+    AssetHandle Request(AssetType type, const std::string& path, int fontSize) {
+        PROFILE_ALLOC_TAG(AllocTag::ASSETS);
+        std::string resolved = ResolveAssetPath(path);
+        std::string key = std::to_string((int)type) + ":" + std::to_string(fontSize) + ":" + resolved;
+        auto found = cacheIndex.find(key);
+        if (found != cacheIndex.end()) {
+            Entry& entry = entries[found->second];
+            entry.refCount++;
+            return {found->second, entry.generation};
+        }
+
+        uint32_t index;
+        if (!freeSlots.empty()) {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            index = (uint32_t)entries.size();
+            entries.emplace_back();
+        }
+        Entry& entry = entries[index];
+        entry.key = key;
+        entry.type = type;
+        entry.state = AssetState::LOADING;
+        entry.refCount = 1;
+        cacheIndex[key] = index;
+        pendingCount++;
+
+        std::unique_ptr<DecodeJob> job(new DecodeJob{index, entry.generation, type, resolved, fontSize});
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queued.push_back(std::move(job));
+        }
+        wake.notify_one();
+        return {index, entry.generation};
+    }
+
+    Entry* Find(AssetHandle handle) {
+        if (handle.index >= entries.size() || entries[handle.index].generation != handle.generation) return nullptr;
+        return entries[handle.index].key.empty() ? nullptr : &entries[handle.index];
+    }
+
+    const Entry* Find(AssetHandle handle) const { return const_cast<AssetManager*>(this)->Find(handle); }
+
+    void LoaderMain() {
+        PROFILE_ALLOC_TAG(AllocTag::ASSETS);
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [this] { return stopRequested || !queued.empty(); });
+            if (stopRequested) break;
+            std::unique_ptr<DecodeJob> job = std::move(queued.front());
+            queued.pop_front();
+            lock.unlock();
+
+            Decode(*job);
+
+            lock.lock();
+            decoded.push_back(std::move(job));
+        }
+    }
+
+    // Loader thread: file reads and CPU-side decoding only
+    static void Decode(DecodeJob& job) {
+        if (!FileExists(job.path.c_str())) return;
+        switch (job.type) {
+            case AssetType::TEXTURE:
+                job.image = LoadImage(job.path.c_str());
+                job.ok = job.image.data != nullptr;
+                break;
+            case AssetType::SOUND:
+                job.wave = LoadWave(job.path.c_str());
+                job.ok = job.wave.data != nullptr;
+                break;
+            case AssetType::FONT: {
+                // TTF/OTF are rasterized here; other formats (BMFont, image fonts) load in Finish()
+                if (!IsFileExtension(job.path.c_str(), ".ttf;.otf")) {
+                    job.ok = true;
+                    break;
+                }
+                int size = 0;
+                unsigned char* data = LoadFileData(job.path.c_str(), &size);
+                if (!data) break;
+                job.glyphs = LoadFontData(data, size, job.fontSize, nullptr, FONT_GLYPHS, FONT_DEFAULT);
+                UnloadFileData(data);
+                if (!job.glyphs) break;
+                job.glyphCount = FONT_GLYPHS;
+                job.image = GenImageFontAtlas(job.glyphs, &job.glyphRecs, job.glyphCount, job.fontSize, FONT_PADDING, 0);
+                job.ok = job.image.data != nullptr;
+                break;
+            }
+        }
+    }
+
+    // Main thread: hands the decoded data to raylib, or throws it away if the asset was released meanwhile
+    void Finish(DecodeJob& job) {
+        Entry* entry = Find({job.index, job.generation});
+        if (!entry) {
+            DiscardDecoded(job);
+            return;
+        }
+        pendingCount--;
+
+        if (!job.ok) {
+            DiscardDecoded(job); // Whatever decoded before the failure, e.g. font glyphs without an atlas
+        } else {
+            switch (job.type) {
+                case AssetType::TEXTURE:
+                    entry->texture = LoadTextureFromImage(job.image);
+                    UnloadImage(job.image);
+                    job.ok = entry->texture.id != 0;
+                    break;
+                case AssetType::SOUND:
+                    entry->sound = LoadSoundFromWave(job.wave);
+                    UnloadWave(job.wave);
+                    job.ok = entry->sound.frameCount > 0;
+                    break;
+                case AssetType::FONT:
+                    if (job.glyphs) {
+                        Font font = {};
+                        font.baseSize = job.fontSize;
+                        font.glyphCount = job.glyphCount;
+                        font.glyphPadding = FONT_PADDING;
+                        font.glyphs = job.glyphs;
+                        font.recs = job.glyphRecs;
+                        font.texture = LoadTextureFromImage(job.image);
+                        UnloadImage(job.image);
+                        entry->font = font;
+                    } else {
+                        entry->font = LoadFont(job.path.c_str());
+                    }
+                    job.ok = entry->font.texture.id != 0;
+                    break;
+            }
+        }
+
+        entry->state = job.ok ? AssetState::READY : AssetState::FAILED;
+        if (!job.ok) printf("[WARNING] Could not load asset %s\n", job.path.c_str());
+    }
+
+    static void DiscardDecoded(DecodeJob& job) {
+        if (job.image.data) UnloadImage(job.image);
+        if (job.wave.data) UnloadWave(job.wave);
+        if (job.glyphs) UnloadFontData(job.glyphs, job.glyphCount);
+        if (job.glyphRecs) MemFree(job.glyphRecs);
+        job.image = Image{};
+        job.wave = Wave{};
+        job.glyphs = nullptr;
+        job.glyphRecs = nullptr;
+    }
+
+    static void UnloadEntry(Entry& entry) {
+        switch (entry.type) {
+            case AssetType::TEXTURE: UnloadTexture(entry.texture); break;
+            case AssetType::SOUND: UnloadSound(entry.sound); break;
+            case AssetType::FONT: UnloadFont(entry.font); break;
+        }
+        entry.texture = Texture2D{};
+        entry.sound = Sound{};
+        entry.font = Font{};
+    }
+
+    // Main thread only
+    std::vector<Entry> entries;
+    std::vector<uint32_t> freeSlots;
+    std::unordered_map<std::string, uint32_t> cacheIndex;
+    std::deque<std::unique_ptr<DecodeJob>> uploads; // Decoded, waiting for the upload budget
+    int pendingCount = 0;
+
+    std::vector<std::thread> loaders;
+    std::mutex mutex;
+    std::condition_variable wake;
+
+    // Guarded by mutex
+    std::deque<std::unique_ptr<DecodeJob>> queued;
+    std::deque<std::unique_ptr<DecodeJob>> decoded;
+    bool stopRequested = false;
+};
@@ -0,0 +1,501 @@
+// Headless benchmark: drives Game with a scripted input stream in a hidden
+// window and prints per-phase frame-time statistics as JSON or CSV.
+//
+// Usage: game_bench [--frames N] [--warmup N] [--format json|csv] [--script file] [--entities N] [--threads N]
+//                   [--record file] [--replay file] [--fail-on-alloc] [--baseline report.json]
+//
+// --entities spawns N bouncing squares next to the player, to measure how the
+// entity systems (the Simulate zone) and DrawGame scale. --threads sets the
+// job system's worker threads (0 = one per extra core); the default is the
+// saved setting.
+//
+// --record writes the input the run consumed to an input log (input_log.h);
+// --replay drives the run from such a log instead of a script, for example
+// one recorded by a player with GAME_RECORD_INPUT set. A replay runs until
+// the log ends unless --frames stops it sooner, and as fast as the machine
+// allows, so long soak sessions replay in a fraction of their length.
+//
+// --fail-on-alloc exits with status 2 if any thread allocated with operator
+// new during the measured frames (warmup excluded), after printing the report
+// and the first offending frame with its subsystem tags. CI runs it to keep
+// the frame loop allocation-free.
+//
+// --baseline reads a JSON report from an earlier run of the same scenario,
+// typically a plain -O2 build (see build_release.sh), and adds each zone's
+// speedup over it: baseline time / this run's time, so above 1 is faster.
+//
+// Script format, one step per line ('#' starts a comment):
+//   <frames> idle
+//   <frames> press KEY [KEY...]   keys go down on the first frame, then release
+//   <frames> hold KEY [KEY...]    keys stay down for the whole step
+// The script loops until the requested number of frames has run.
+
+#define GAME_ALLOC_COUNTER_IMPLEMENTATION // Counts heap allocations for the profiler
+#include "game.h"
+#include <array>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#if !GAME_PROFILER
+#error "game_bench needs the frame profiler (build with -DGAME_PROFILER=1)"
+#endif
+
+// Default scenario: every menu, a burst of volume changes (each one saves), movement and pause
+static const char* DEFAULT_SCRIPT = R"(
+# Main menu -> Settings
+1 press DOWN
+10 idle
+1 press ENTER
+10 idle
+# Select Volume and step it up and down, saving each time
+1 press UP
+5 idle
+1 press RIGHT
+5 idle
+1 press RIGHT
+5 idle
+1 press RIGHT
+5 idle
+1 press LEFT
+5 idle
+1 press LEFT
+5 idle
+1 press LEFT
+20 idle
+# Back to the main menu and start the game
+1 press ESCAPE
+10 idle
+1 press ENTER
+# Move around
+120 hold D S
+120 hold A W
+60 hold RIGHT
+# Pause, resume, pause, return to menu
+1 press ESCAPE
+30 idle
+1 press ESCAPE
+30 hold LEFT UP
+1 press ESCAPE
+30 idle
+1 press M
+30 idle
+)";
+
+struct ScriptStep {
+    enum class Kind { IDLE, PRESS, HOLD };
+    Kind kind;
+    int frames;
+    std::vector<int> keys;
+};
+
+static int ParseKeyName(const std::string& name) {
+    struct KeyName { const char* name; int key; };
+    static const KeyName keyNames[] = {
+        {"W", KEY_W}, {"A", KEY_A}, {"S", KEY_S}, {"D", KEY_D}, {"M", KEY_M},
+        {"UP", KEY_UP}, {"DOWN", KEY_DOWN}, {"LEFT", KEY_LEFT}, {"RIGHT", KEY_RIGHT},
+        {"ENTER", KEY_ENTER}, {"SPACE", KEY_SPACE}, {"ESCAPE", KEY_ESCAPE},
+        {"F1", KEY_F1}, {"F2", KEY_F2}
+    };
+    for (const auto& entry : keyNames) {
+        if (name == entry.name) return entry.key;
+    }
+    return -1;
+}
+
+static bool ParseScript(std::istream& in, std::vector<ScriptStep>& steps) {
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+
+        std::istringstream words(line);
+        ScriptStep step;
+        std::string kind;
+        if (!(words >> step.frames)) continue; // Blank line
+        if (!(words >> kind) || step.frames <= 0) {
+            fprintf(stderr, "[ERROR] Script line %d: expected '<frames> idle|press|hold'\n", lineNumber);
+            return false;
+        }
+        if (kind == "idle") step.kind = ScriptStep::Kind::IDLE;
+        else if (kind == "press") step.kind = ScriptStep::Kind::PRESS;
+        else if (kind == "hold") step.kind = ScriptStep::Kind::HOLD;
+        else {
+            fprintf(stderr, "[ERROR] Script line %d: unknown action '%s'\n", lineNumber, kind.c_str());
+            return false;
+        }
+
+        std::string keyName;
+        while (words >> keyName) {
+            int key = ParseKeyName(keyName);
+            if (key < 0) {
+                fprintf(stderr, "[ERROR] Script line %d: unknown key '%s'\n", lineNumber, keyName.c_str());
+                return false;
+            }
+            step.keys.push_back(key);
+        }
+        steps.push_back(step);
+    }
+    return !steps.empty();
+}
+
+// Plays the script back with a fixed frame time so runs are repeatable
+class ScriptedInputSource : public InputSource {
+public:
+    ScriptedInputSource(std::vector<ScriptStep> steps, float frameTime)
+        : steps(std::move(steps)), frameTime(frameTime) {}
+
+    void Capture(InputState& state) override {
+        state.Clear();
+        state.frameTime = frameTime;
+
+        const ScriptStep& step = steps[stepIndex];
+        bool firstFrame = stepFrame == 0;
+        for (int key : step.keys) {
+            if (step.kind == ScriptStep::Kind::HOLD || firstFrame) {
+                state.keysDown[key] = true;
+            }
+            if (firstFrame) {
+                state.keysPressed[key] = true;
+                state.anyKeyPressed = true;
+            }
+        }
+
+        if (++stepFrame >= step.frames) {
+            stepFrame = 0;
+            stepIndex = (stepIndex + 1) % steps.size();
+        }
+    }
+
+private:
+    std::vector<ScriptStep> steps;
+    float frameTime;
+    size_t stepIndex = 0;
+    int stepFrame = 0;
+};
+
+// One number from a JSON report this program wrote: field inside "section": {...},
+// or the first one anywhere for an empty section (the top-level fields come first)
+static bool FindReportValue(const std::string& report, const char* section, const char* field, double& value) {
+    size_t at = 0;
+    size_t end = std::string::npos;
+    if (*section) {
+        at = report.find(std::string("\"") + section + "\": {");
+        if (at == std::string::npos) return false;
+        end = report.find('}', at);
+    }
+    size_t found = report.find(std::string("\"") + field + "\": ", at);
+    if (found == std::string::npos || found > end) return false;
+    value = strtod(report.c_str() + found + strlen(field) + 4, nullptr);
+    return true;
+}
+
+struct ZoneSummary {
+    size_t samples = 0;
+    double meanMs = 0, p50Ms = 0, p95Ms = 0, p99Ms = 0, maxMs = 0;
+};
+
+static ZoneSummary Summarize(std::vector<uint32_t>& nanos) {
+    ZoneSummary summary;
+    summary.samples = nanos.size();
+    if (nanos.empty()) return summary;
+
+    std::sort(nanos.begin(), nanos.end());
+    auto percentile = [&](double p) {
+        size_t index = std::min(nanos.size() - 1, (size_t)(p * nanos.size()));
+        return nanos[index] / 1e6;
+    };
+    double total = 0;
+    for (uint32_t value : nanos) total += value;
+    summary.meanMs = total / nanos.size() / 1e6;
+    summary.p50Ms = percentile(0.50);
+    summary.p95Ms = percentile(0.95);
+    summary.p99Ms = percentile(0.99);
+    summary.maxMs = nanos.back() / 1e6;
+    return summary;
+}
+
+int main(int argc, char** argv) {
+    int frames = 10000;
+    int warmupFrames = 120;
+    std::string format = "json";
+    std::string scriptPath;
+    int extraEntities = 0;
+    int workerThreads = -1;
+    std::string recordPath;
+    std::string replayPath;
+    bool framesGiven = false;
+    bool failOnAlloc = false;
+    std::string baselinePath;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--frames" && hasValue) {
+            frames = std::max(1, atoi(argv[++i]));
+            framesGiven = true;
+        }
+        else if (arg == "--warmup" && hasValue) warmupFrames = std::max(0, atoi(argv[++i]));
+        else if (arg == "--format" && hasValue) format = argv[++i];
+        else if (arg == "--script" && hasValue) scriptPath = argv[++i];
+        else if (arg == "--entities" && hasValue) extraEntities = std::max(0, atoi(argv[++i]));
+        else if (arg == "--threads" && hasValue) workerThreads = std::max(0, atoi(argv[++i]));
+        else if (arg == "--record" && hasValue) recordPath = argv[++i];
+        else if (arg == "--replay" && hasValue) replayPath = argv[++i];
+        else if (arg == "--fail-on-alloc") failOnAlloc = true;
+        else if (arg == "--baseline" && hasValue) baselinePath = argv[++i];
+        else {
+            fprintf(stderr, "Usage: %s [--frames N] [--warmup N] [--format json|csv] [--script file] [--entities N] [--threads N]"
+                            " [--record file] [--replay file] [--fail-on-alloc] [--baseline report.json]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (format != "json" && format != "csv") {
+        fprintf(stderr, "[ERROR] Unknown format '%s'\n", format.c_str());
+        return 1;
+    }
+
+    // A first pass over the log gives its length, so the sample buffers can be sized for it
+    InputReplaySource replay;
+    if (!replayPath.empty()) {
+        InputReplaySource counter;
+        if (!counter.Open(replayPath) || !replay.Open(replayPath)) {
+            fprintf(stderr, "[ERROR] Could not load input log %s\n", replayPath.c_str());
+            return 1;
+        }
+        InputState state;
+        while (!counter.IsFinished()) counter.Capture(state);
+        int logFrames = (int)std::min<uint64_t>(counter.GetReplayedFrames(), INT_MAX);
+        if (logFrames <= warmupFrames) {
+            fprintf(stderr, "[ERROR] Input log %s has %d frames, not more than the %d warmup frames\n",
+                    replayPath.c_str(), logFrames, warmupFrames);
+            return 1;
+        }
+        frames = framesGiven ? std::min(frames, logFrames - warmupFrames) : logFrames - warmupFrames;
+        if (replay.GetWidth() != 1280 || replay.GetHeight() != 720) {
+            fprintf(stderr, "[WARNING] Input log was recorded at %dx%d; mouse input assumes the bench's 1280x720\n",
+                    replay.GetWidth(), replay.GetHeight());
+        }
+    }
+
+    std::string baseline;
+    if (!baselinePath.empty()) {
+        std::ifstream in(baselinePath);
+        std::stringstream text;
+        text << in.rdbuf();
+        baseline = text.str();
+        double baselineEntities = 0;
+        if (!in.is_open() || !FindReportValue(baseline, "", "entities", baselineEntities)) {
+            fprintf(stderr, "[ERROR] Could not read baseline report %s (it must be --format json)\n", baselinePath.c_str());
+            return 1;
+        }
+        if ((int)baselineEntities != extraEntities + 1) {
+            fprintf(stderr, "[WARNING] Baseline ran with %d entities, this run with %d; the speedups compare different work\n",
+                    (int)baselineEntities, extraEntities + 1);
+        }
+    }
+
+    std::vector<ScriptStep> steps;
+    if (scriptPath.empty()) {
+        std::istringstream in(DEFAULT_SCRIPT);
+        ParseScript(in, steps);
+    } else {
+        std::ifstream in(scriptPath);
+        if (!in.is_open() || !ParseScript(in, steps)) {
+            fprintf(stderr, "[ERROR] Could not load script %s\n", scriptPath.c_str());
+            return 1;
+        }
+    }
+
+    // raylib's per-resource INFO lines would drown out the game's own log
+    SetTraceLogLevel(LOG_WARNING);
+
+    std::filesystem::path savePath = std::filesystem::temp_directory_path() / "game_bench_save.dat";
+    std::filesystem::remove(savePath);
+
+    ScriptedInputSource script(steps, 1.0f / 60.0f);
+    GameOptions options;
+    options.headless = true;
+    options.saveFilePath = savePath.string();
+    options.inputSource = replayPath.empty() ? (InputSource*)&script : &replay;
+    options.extraEntities = extraEntities;
+    options.workerThreads = workerThreads;
+    options.recordInputPath = recordPath;
+
+    // The game logs to stdout; send that to stderr while it runs so stdout only carries the report
+    fflush(stdout);
+    int reportFd = dup(STDOUT_FILENO);
+    dup2(STDERR_FILENO, STDOUT_FILENO);
+
+    std::vector<std::vector<uint32_t>> zoneSamples(FrameProfiler::ZONE_COUNT);
+    std::vector<uint32_t> allocationSamples;
+    std::vector<uint32_t> latencySamples; // Frames that consumed input only
+    std::array<uint64_t, FrameProfiler::ALLOC_TAG_COUNT> taggedAllocations{}; // Every thread, measured frames
+    int firstAllocatingFrame = -1;
+    FrameProfiler::FrameRecord firstAllocating{};
+    int collectedFrames = 0;
+    uint64_t simulateTicks = 0;
+    uint64_t simulateNanos = 0;
+    int usedWorkerThreads = 0;
+    // Reserved up front so collecting samples doesn't show up as frame allocations
+    for (auto& samples : zoneSamples) samples.reserve(frames + 1);
+    allocationSamples.reserve(frames + 1);
+    latencySamples.reserve(frames + 1);
+    {
+        Game game(options);
+        FrameProfiler& profiler = game.GetProfiler();
+        usedWorkerThreads = game.GetWorkerThreadCount();
+
+        auto collectLatestFrame = [&]() {
+            FrameProfiler::FrameRecord record;
+            if (!profiler.GetLatestFrame(record)) return;
+            allocationSamples.push_back(record.allocations);
+            uint64_t frameTagged = 0;
+            for (int tag = 0; tag < FrameProfiler::ALLOC_TAG_COUNT; tag++) {
+                taggedAllocations[tag] += record.taggedAllocations[tag];
+                frameTagged += record.taggedAllocations[tag];
+            }
+            if (firstAllocatingFrame < 0 && (record.allocations > 0 || frameTagged > 0)) {
+                firstAllocatingFrame = warmupFrames + collectedFrames;
+                firstAllocating = record;
+            }
+            collectedFrames++;
+            if (record.inputLatency != 0) latencySamples.push_back(record.inputLatency);
+            simulateTicks += record.calls[(int)ProfileZone::SIMULATE];
+            simulateNanos += record.nanos[(int)ProfileZone::SIMULATE];
+            for (int zone = 0; zone < FrameProfiler::ZONE_COUNT; zone++) {
+                if (record.IsActive((ProfileZone)zone)) {
+                    zoneSamples[zone].push_back(record.nanos[zone]);
+                }
+            }
+        };
+
+        for (int frame = 0; frame < warmupFrames + frames; frame++) {
+            game.RunFrame();
+            // RunFrame commits the previous frame when it starts, so collection lags by one
+            if (frame > warmupFrames) collectLatestFrame();
+        }
+        profiler.NextFrame();
+        collectLatestFrame();
+    }
+    CloseWindow();
+    std::filesystem::remove(savePath);
+
+    std::cout.flush();
+    fflush(stdout);
+    dup2(reportFd, STDOUT_FILENO);
+    close(reportFd);
+
+    if (format == "csv") {
+        printf("zone,samples,mean_ms,p50_ms,p95_ms,p99_ms,max_ms\n");
+    } else {
+        printf("{\n  \"frames\": %d,\n  \"warmup_frames\": %d,\n  \"entities\": %d,\n  \"worker_threads\": %d,\n  \"zones\": {",
+               frames, warmupFrames, extraEntities + 1, usedWorkerThreads);
+    }
+    // Per-frame heap allocations on the frame thread
+    std::sort(allocationSamples.begin(), allocationSamples.end());
+    uint64_t totalAllocations = 0;
+    for (uint32_t value : allocationSamples) totalAllocations += value;
+    double meanAllocations = allocationSamples.empty() ? 0.0 : (double)totalAllocations / allocationSamples.size();
+    uint32_t maxAllocations = allocationSamples.empty() ? 0 : allocationSamples.back();
+    size_t allocatingFrames = allocationSamples.end() -
+        std::upper_bound(allocationSamples.begin(), allocationSamples.end(), 0u);
+
+    // Entity updates per second of Simulate time: every tick moves every entity once
+    uint64_t entityCount = (uint64_t)extraEntities + 1;
+    double entityUpdatesPerSec = simulateNanos > 0 ? (double)(simulateTicks * entityCount) / (simulateNanos / 1e9) : 0.0;
+    double nsPerEntity = simulateTicks > 0 ? (double)simulateNanos / (simulateTicks * entityCount) : 0.0;
+
+    // Input sample to the end of the swap; the script has no earlier event time to start from
+    ZoneSummary latency = Summarize(latencySamples);
+
+    std::vector<ZoneSummary> summaries(FrameProfiler::ZONE_COUNT);
+    bool first = true;
+    for (int zone = 0; zone < FrameProfiler::ZONE_COUNT; zone++) {
+        ZoneSummary s = summaries[zone] = Summarize(zoneSamples[zone]);
+        const char* name = GetProfileZoneName((ProfileZone)zone);
+        if (format == "csv") {
+            printf("%s,%zu,%.4f,%.4f,%.4f,%.4f,%.4f\n", name, s.samples, s.meanMs, s.p50Ms, s.p95Ms, s.p99Ms, s.maxMs);
+        } else {
+            printf("%s\n    \"%s\": {\"samples\": %zu, \"mean_ms\": %.4f, \"p50_ms\": %.4f, \"p95_ms\": %.4f, \"p99_ms\": %.4f, \"max_ms\": %.4f}",
+                   first ? "" : ",", name, s.samples, s.meanMs, s.p50Ms, s.p95Ms, s.p99Ms, s.maxMs);
+        }
+        first = false;
+    }
+    if (format == "json") {
+        printf("\n  },\n  \"simulation\": {\"ticks\": %llu, \"entity_updates_per_sec\": %.0f, \"ns_per_entity_update\": %.3f},",
+               (unsigned long long)simulateTicks, entityUpdatesPerSec, nsPerEntity);
+        printf("\n  \"input_latency\": {\"samples\": %zu, \"mean_ms\": %.4f, \"p50_ms\": %.4f, \"p95_ms\": %.4f, \"p99_ms\": %.4f, \"max_ms\": %.4f},",
+               latency.samples, latency.meanMs, latency.p50Ms, latency.p95Ms, latency.p99Ms, latency.maxMs);
+        printf("\n  \"allocations\": {\"total\": %llu, \"mean_per_frame\": %.4f, \"max_per_frame\": %u, \"frames_allocating\": %zu},",
+               (unsigned long long)totalAllocations, meanAllocations, maxAllocations, allocatingFrames);
+        printf("\n  \"allocations_by_tag\": {");
+        for (int tag = 0; tag < FrameProfiler::ALLOC_TAG_COUNT; tag++) {
+            AllocTagStats heap = GetAllocTagStats((AllocTag)tag);
+            printf("%s\n    \"%s\": {\"measured\": %llu, \"total\": %llu, \"peak_bytes\": %lld}", tag == 0 ? "" : ",",
+                   GetAllocTagName((AllocTag)tag), (unsigned long long)taggedAllocations[tag],
+                   (unsigned long long)heap.allocations, (long long)heap.peakBytes);
+        }
+        printf("\n  }");
+    } else {
+        fprintf(stderr, "[BENCH] Worker threads: %d\n", usedWorkerThreads);
+        fprintf(stderr, "[BENCH] Simulation: %llu ticks, %.0f entity updates/s, %.3f ns/entity update\n",
+                (unsigned long long)simulateTicks, entityUpdatesPerSec, nsPerEntity);
+        fprintf(stderr, "[BENCH] Input latency: %zu frames, p50 %.4f, p95 %.4f, p99 %.4f, max %.4f ms\n",
+                latency.samples, latency.p50Ms, latency.p95Ms, latency.p99Ms, latency.maxMs);
+        fprintf(stderr, "[BENCH] Allocations: %llu total, %.4f/frame mean, %u max, %zu frames allocating\n",
+                (unsigned long long)totalAllocations, meanAllocations, maxAllocations, allocatingFrames);
+        for (int tag = 0; tag < FrameProfiler::ALLOC_TAG_COUNT; tag++) {
+            AllocTagStats heap = GetAllocTagStats((AllocTag)tag);
+            fprintf(stderr, "[BENCH] Allocations (%s): %llu measured, %llu total, %lld peak bytes\n", GetAllocTagName((AllocTag)tag),
+                    (unsigned long long)taggedAllocations[tag], (unsigned long long)heap.allocations, (long long)heap.peakBytes);
+        }
+    }
+
+    if (!baseline.empty()) {
+        // Zones that ran in both; one the scenario never reached has nothing to compare
+        if (format == "json") printf(",\n  \"speedup_vs_baseline\": {");
+        fprintf(stderr, "[BENCH] Speedup over %s (baseline / this run):", baselinePath.c_str());
+        first = true;
+        for (int zone = 0; zone < FrameProfiler::ZONE_COUNT; zone++) {
+            const char* name = GetProfileZoneName((ProfileZone)zone);
+            const ZoneSummary& s = summaries[zone];
+            double baseMean = 0, baseP99 = 0;
+            if (s.samples == 0 || s.meanMs <= 0 || s.p99Ms <= 0 || !FindReportValue(baseline, name, "mean_ms", baseMean) ||
+                !FindReportValue(baseline, name, "p99_ms", baseP99) || baseMean <= 0) {
+                continue;
+            }
+            if (format == "json") {
+                printf("%s\n    \"%s\": {\"mean\": %.3f, \"p99\": %.3f}", first ? "" : ",", name, baseMean / s.meanMs, baseP99 / s.p99Ms);
+            }
+            fprintf(stderr, "%s %s mean %.3fx p99 %.3fx", first ? "" : ",", name, baseMean / s.meanMs, baseP99 / s.p99Ms);
+            first = false;
+        }
+        double baseUpdates = 0;
+        if (entityUpdatesPerSec > 0 && FindReportValue(baseline, "simulation", "entity_updates_per_sec", baseUpdates) && baseUpdates > 0) {
+            if (format == "json") printf("%s\n    \"entity_updates_per_sec\": %.3f", first ? "" : ",", entityUpdatesPerSec / baseUpdates);
+            fprintf(stderr, "%s entity updates/s %.3fx", first ? "" : ",", entityUpdatesPerSec / baseUpdates);
+        }
+        if (format == "json") printf("\n  }");
+        fprintf(stderr, "\n");
+    }
+    if (format == "json") printf("\n}\n");
+
+    if (failOnAlloc && firstAllocatingFrame >= 0) {
+        fprintf(stderr, "[ERROR] Steady-state allocation: frame %d allocated %u times on the frame thread;",
+                firstAllocatingFrame, firstAllocating.allocations);
+        for (int tag = 0; tag < FrameProfiler::ALLOC_TAG_COUNT; tag++) {
+            if (firstAllocating.taggedAllocations[tag] > 0) {
+                fprintf(stderr, " %s %u", GetAllocTagName((AllocTag)tag), firstAllocating.taggedAllocations[tag]);
+            }
+        }
+        fprintf(stderr, "\n");
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,42 @@
+#!/bin/bash
+
+# Builds the optimized release (LTO + PGO) and reports how much faster it is
+# than a plain -O2 build of the same sources:
+#
+#   build-o2/        Release at -O2, the baseline
+#   build-release/   Release with GAME_LTO=ON, built instrumented, trained with
+#                    the pgo_train target, then rebuilt with GAME_PGO=USE
+#
+# Any arguments are passed to every CMake configure, e.g.
+#   ./build_release.sh -DGAME_STATIC_RAYLIB=ON -DGAME_PGO_LOGS=$HOME/sessions
+# GAME_PGO_LOGS is a directory of .rtin logs recorded with GAME_RECORD_INPUT;
+# they are replayed during training on top of the bench's scripted scenario.
+#
+# The benchmarks open a hidden window, so they need a display (or xvfb-run).
+
+set -e
+cd "$(dirname "$0")"
+
+echo "=== Baseline: plain -O2 build ==="
+cmake -S . -B build-o2 -DCMAKE_BUILD_TYPE=Release -DGAME_LTO=OFF -DGAME_PGO= "$@"
+cmake --build build-o2 --parallel
+
+echo "=== Optimized build: instrument, train, rebuild with the profile ==="
+cmake -S . -B build-release -DCMAKE_BUILD_TYPE=Release -DGAME_LTO=ON -DGAME_PGO=GENERATE "$@"
+cmake --build build-release --parallel
+cmake --build build-release --target pgo_train
+cmake -S . -B build-release -DGAME_PGO=USE
+cmake --build build-release --parallel
+
+# Same scenarios in both builds; the speedups go to stderr and into each report's speedup_vs_baseline
+run_scenario() {
+    local name="$1"
+    shift
+    echo "=== Scenario: $name ==="
+    ./build-o2/game_bench "$@" > "build-o2/bench_$name.json"
+    ./build-release/game_bench "$@" --baseline "build-o2/bench_$name.json" > "build-release/bench_$name.json"
+}
+run_scenario scripted --frames 5000
+run_scenario entities --frames 1000 --entities 100000
+
+echo "Optimized binaries are in build-release/; reports in build-o2/ and build-release/bench_*.json"
@@ -0,0 +1,267 @@
+#pragma once
+
+#include "input.h"
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Tracks every connected game controller and follows hot-plug events.
+//
+// SDL initialization, the mapping database load and every device open/close
+// run on a background thread, so neither startup nor plugging in a pad blocks
+// the frame thread. The frame thread only drains the SDL event queue (once per
+// frame, from LiveInputSource) and adopts devices the worker has opened.
+class ControllerManager {
+public:
+    static constexpr int MAX_CONTROLLERS = 4;
+
+    struct Slot {
+        SDL_GameController* handle = nullptr;
+        SDL_JoystickID instanceId = -1;
+        std::string name;
+        ControllerState state;
+
+        bool IsConnected() const { return handle != nullptr; }
+    };
+
+    ~ControllerManager() { Shutdown(); }
+
+    // Starts SDL on the worker thread; mappingFile may be empty or missing
+    void Start(const std::string& mappingFile) {
+        if (worker.joinable()) return;
+        stopRequested = false;
+        startTime = std::chrono::steady_clock::now();
+        worker = std::thread(&ControllerManager::WorkerMain, this, mappingFile);
+    }
+
+    // Closes all devices, quits SDL and joins the worker
+    void Shutdown() {
+        if (!worker.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (Slot& slot : slots) {
+                if (slot.handle) {
+                    requests.push_back({Request::Type::CLOSE, -1, slot.handle});
+                }
+                slot = Slot();
+            }
+            stopRequested = true;
+        }
+        wake.notify_one();
+        worker.join();
+        activeSlot = -1;
+    }
+
+    bool IsReady() const { return ready.load(std::memory_order_acquire); }
+
+    // True once SDL_Init() has returned on the worker, whether or not it succeeded
+    bool IsInitFinished() const { return initFinished.load(std::memory_order_acquire); }
+
+    // When Start() was called and when SDL_Init() returned; the latter is valid once IsInitFinished()
+    std::chrono::steady_clock::time_point GetStartTime() const { return startTime; }
+    std::chrono::steady_clock::time_point GetReadyTime() const { return readyTime; }
+
+    // Drains the SDL event queue: device add/remove plus button and axis events.
+    // Call once per frame on the frame thread.
+    void ProcessEvents() {
+        if (!IsReady()) return; // SDL is still initializing on the worker
+
+        AdoptOpenedControllers();
+        for (Slot& slot : slots) {
+            slot.state.BeginFrame();
+        }
+
+        SDL_Event event;
+        while (SDL_PollEvent(&event)) {
+            switch (event.type) {
+                case SDL_CONTROLLERDEVICEADDED:
+                    // 'which' is a device index here; opening happens on the worker
+                    PushRequest({Request::Type::OPEN, event.cdevice.which, nullptr});
+                    break;
+                case SDL_CONTROLLERDEVICEREMOVED:
+                    // 'which' is an instance ID here
+                    RemoveController(event.cdevice.which);
+                    break;
+                case SDL_CONTROLLERBUTTONDOWN:
+                case SDL_CONTROLLERBUTTONUP: {
+                    int index = FindSlot(event.cbutton.which);
+                    if (index < 0) break;
+                    slots[index].state.ApplyEvent(event);
+                    // The pad that last pressed a button drives the menus
+                    if (event.type == SDL_CONTROLLERBUTTONDOWN) activeSlot = index;
+                    break;
+                }
+                case SDL_CONTROLLERAXISMOTION: {
+                    int index = FindSlot(event.caxis.which);
+                    if (index < 0) break;
+                    slots[index].state.ApplyEvent(event);
+                    if (activeSlot < 0) activeSlot = index;
+                    break;
+                }
+            }
+        }
+    }
+
+    // State of the controller that was used most recently (disconnected if none)
+    const ControllerState& GetActiveState() const {
+        static const ControllerState disconnected;
+        return activeSlot >= 0 ? slots[activeSlot].state : disconnected;
+    }
+
+    const Slot& GetSlot(int index) const { return slots[index]; }
+
+    int GetConnectedCount() const {
+        int count = 0;
+        for (const Slot& slot : slots) {
+            if (slot.IsConnected()) count++;
+        }
+        return count;
+    }
+
+private:
+    struct Request {
+        enum class Type { OPEN, CLOSE };
+        Type type;
+        int deviceIndex;
+        SDL_GameController* handle;
+    };
+
+    struct Opened {
+        SDL_GameController* handle;
+        SDL_JoystickID instanceId;
+        std::string name;
+    };
+
+    void PushRequest(const Request& request) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            requests.push_back(request);
+        }
+        wake.notify_one();
+    }
+
+    int FindSlot(SDL_JoystickID instanceId) const {
+        for (int i = 0; i < MAX_CONTROLLERS; i++) {
+            if (slots[i].handle && slots[i].instanceId == instanceId) return i;
+        }
+        return -1;
+    }
+
+    void AdoptOpenedControllers() {
+        std::vector<Opened> adopted;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (opened.empty()) return;
+            adopted.swap(opened);
+        }
+
+        for (Opened& device : adopted) {
+            int freeSlot = -1;
+            for (int i = 0; i < MAX_CONTROLLERS && freeSlot < 0; i++) {
+                if (!slots[i].handle) freeSlot = i;
+            }
+            // Unplugged again before the worker finished, already tracked, or no room left
+            if (!SDL_GameControllerGetAttached(device.handle) || FindSlot(device.instanceId) >= 0 || freeSlot < 0) {
+                PushRequest({Request::Type::CLOSE, -1, device.handle});
+                continue;
+            }
+
+            Slot& slot = slots[freeSlot];
+            slot.handle = device.handle;
+            slot.instanceId = device.instanceId;
+            slot.name = device.name;
+            slot.state.Reset();
+            slot.state.connected = true;
+            if (activeSlot < 0) activeSlot = freeSlot;
+            printf("SDL2 Controller connected: %s (slot %d)\n", slot.name.c_str(), freeSlot);
+        }
+    }
+
+    void RemoveController(SDL_JoystickID instanceId) {
+        int index = FindSlot(instanceId);
+        if (index < 0) return;
+
+        printf("SDL2 Controller disconnected: %s (slot %d)\n", slots[index].name.c_str(), index);
+        PushRequest({Request::Type::CLOSE, -1, slots[index].handle});
+        slots[index] = Slot();
+
+        if (activeSlot == index) {
+            activeSlot = -1;
+            for (int i = 0; i < MAX_CONTROLLERS && activeSlot < 0; i++) {
+                if (slots[i].handle) activeSlot = i;
+            }
+        }
+    }
+
+    void WorkerMain(std::string mappingFile) {
+        if (SDL_Init(SDL_INIT_GAMECONTROLLER) < 0) {
+            printf("SDL2 could not initialize! SDL_Error: %s\n", SDL_GetError());
+            readyTime = std::chrono::steady_clock::now();
+            initFinished.store(true, std::memory_order_release);
+            return;
+        }
+        if (!mappingFile.empty()) {
+            int mappings = SDL_GameControllerAddMappingsFromFile(mappingFile.c_str());
+            if (mappings >= 0) {
+                printf("[INFO] Loaded %d controller mappings from %s\n", mappings, mappingFile.c_str());
+            }
+        }
+        // SDL queues a DEVICEADDED event for every pad already plugged in,
+        // so startup enumeration goes through the same path as hot-plug
+        readyTime = std::chrono::steady_clock::now();
+        ready.store(true, std::memory_order_release);
+        initFinished.store(true, std::memory_order_release);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [this] { return stopRequested || !requests.empty(); });
+            if (requests.empty() && stopRequested) break;
+
+            Request request = requests.front();
+            requests.pop_front();
+            lock.unlock();
+
+            if (request.type == Request::Type::OPEN) {
+                if (SDL_IsGameController(request.deviceIndex)) {
+                    SDL_GameController* handle = SDL_GameControllerOpen(request.deviceIndex);
+                    if (handle) {
+                        const char* name = SDL_GameControllerName(handle);
+                        Opened device{handle, SDL_JoystickInstanceID(SDL_GameControllerGetJoystick(handle)),
+                                      name ? name : "Unknown controller"};
+                        lock.lock();
+                        opened.push_back(std::move(device));
+                        continue;
+                    }
+                }
+            } else {
+                SDL_GameControllerClose(request.handle);
+            }
+            lock.lock();
+        }
+        lock.unlock();
+
+        ready.store(false, std::memory_order_release);
+        SDL_Quit();
+    }
+
+    Slot slots[MAX_CONTROLLERS];
+    int activeSlot = -1;
+
+    std::thread worker;
+    std::atomic<bool> ready{false};
+    std::atomic<bool> initFinished{false};
+    std::chrono::steady_clock::time_point startTime;
+    std::chrono::steady_clock::time_point readyTime; // Written before initFinished (and ready) is set
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<Request> requests; // Frame thread -> worker
+    std::vector<Opened> opened;   // Worker -> frame thread
+    bool stopRequested = false;
+};
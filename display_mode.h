@@ -0,0 +1,168 @@
+#pragma once
+
+#include "raylib.h"
+
+enum class DisplayMode {
+    WINDOWED,
+    BORDERLESS, // Undecorated window covering the monitor; no video mode change
+    EXCLUSIVE   // Real fullscreen; the monitor switches mode, which is slow on most drivers
+};
+
+inline const char* GetDisplayModeName(DisplayMode mode) {
+    switch (mode) {
+        case DisplayMode::WINDOWED: return "windowed";
+        case DisplayMode::BORDERLESS: return "borderless";
+        case DisplayMode::EXCLUSIVE: return "fullscreen";
+        default: return "?";
+    }
+}
+
+// Switches display modes without blocking the frame loop.
+//
+// Request() only records the wanted mode. The next Update() issues the
+// window calls and from then on just watches the window size, which the
+// window system changes asynchronously, often in several steps. Once the
+// size has held still for SETTLE_FRAMES, Update() reports it once, so the
+// caller lays out and rebuilds size-dependent resources a single time.
+// Frames keep being drawn at the old layout in the meantime.
+//
+// Resizes by the user (a resizable window being dragged) go through the same
+// settling path. Main thread only.
+class DisplayModeController {
+public:
+    static constexpr int SETTLE_FRAMES = 3;        // Frames without a size change before layout runs
+    static constexpr double SWITCH_TIMEOUT = 1.0;  // Seconds to wait for a resize that may never come
+    static constexpr double RESIZE_RETRY = 0.15;   // Seconds between re-sending an ignored fullscreen size
+    static constexpr int MAX_RESIZE_RETRIES = 3;
+    static constexpr int WINDOWED_WIDTH = 1280;
+    static constexpr int WINDOWED_HEIGHT = 720;
+
+    // Creates the window in mode; call instead of InitWindow()
+    void OpenWindow(DisplayMode mode, const char* title) {
+        int monitor = GetCurrentMonitor();
+        bool covering = mode != DisplayMode::WINDOWED;
+        InitWindow(covering ? GetMonitorWidth(monitor) : WINDOWED_WIDTH,
+                   covering ? GetMonitorHeight(monitor) : WINDOWED_HEIGHT, title);
+        current = DisplayMode::WINDOWED;
+        Apply(mode);
+        requested = mode;
+        layoutWidth = width = GetScreenWidth();
+        layoutHeight = height = GetScreenHeight();
+        state = State::STABLE;
+        if (mode == DisplayMode::EXCLUSIVE) {
+            // Same size checks and retries as a switch made later
+            state = State::SWITCHING;
+            switchStart = lastRetry = GetTime();
+            retries = 0;
+            stableFrames = 0;
+        }
+    }
+
+    void Request(DisplayMode mode) { requested = mode; }
+
+    // The mode that was last asked for, even if the switch is still settling
+    DisplayMode GetMode() const { return requested; }
+
+    bool IsSettling() const { return state != State::STABLE || requested != current; }
+
+    // Window size the current layout was built for
+    int GetLayoutWidth() const { return layoutWidth; }
+    int GetLayoutHeight() const { return layoutHeight; }
+
+    // Once per frame, before anything reads the layout. True on the frame the
+    // window size settles at a value different from the current layout.
+    bool Update() {
+        double now = GetTime();
+        if (state == State::STABLE && requested != current) {
+            Apply(requested);
+            state = State::SWITCHING;
+            switchStart = lastRetry = now;
+            retries = 0;
+            stableFrames = 0;
+        }
+
+        int w = GetScreenWidth();
+        int h = GetScreenHeight();
+        if (IsWindowResized() || w != width || h != height) {
+            width = w;
+            height = h;
+            stableFrames = 0;
+            if (state == State::STABLE) state = State::SETTLING;
+            if (state == State::SWITCHING) state = State::SWITCHED;
+            return false;
+        }
+        if (state == State::STABLE) return false;
+        stableFrames++;
+
+        if (state == State::SWITCHING || state == State::SWITCHED) {
+            // Some window managers drop the first size request after entering fullscreen
+            if (current == DisplayMode::EXCLUSIVE && retries < MAX_RESIZE_RETRIES && now - lastRetry >= RESIZE_RETRY) {
+                int monitor = GetCurrentMonitor();
+                if (w != GetMonitorWidth(monitor) || h != GetMonitorHeight(monitor)) {
+                    SetWindowSize(GetMonitorWidth(monitor), GetMonitorHeight(monitor));
+                    lastRetry = now;
+                    retries++;
+                    stableFrames = 0;
+                    return false;
+                }
+            }
+            // Without a resize, either the new mode has the old size or the resize is still coming
+            bool atTarget = w == targetWidth && h == targetHeight;
+            bool settled = state == State::SWITCHED || atTarget ? stableFrames >= SETTLE_FRAMES
+                                                                 : now - switchStart >= SWITCH_TIMEOUT;
+            if (!settled) return false;
+        } else if (stableFrames < SETTLE_FRAMES) {
+            return false;
+        }
+
+        state = State::STABLE;
+        if (width == layoutWidth && height == layoutHeight) return false;
+        layoutWidth = width;
+        layoutHeight = height;
+        return true;
+    }
+
+private:
+    enum class State {
+        STABLE,
+        SETTLING,  // Size changed without a request (user resize); waiting for it to stop
+        SWITCHING, // Mode change issued, no resize seen yet
+        SWITCHED   // Mode change issued and the size is moving
+    };
+
+    // Leaves the current mode, then enters mode
+    void Apply(DisplayMode mode) {
+        if (mode == current) return;
+        if (IsWindowFullscreen()) ToggleFullscreen();
+        if (IsWindowState(FLAG_BORDERLESS_WINDOWED_MODE)) ToggleBorderlessWindowed();
+
+        int monitor = GetCurrentMonitor();
+        targetWidth = mode == DisplayMode::WINDOWED ? WINDOWED_WIDTH : GetMonitorWidth(monitor);
+        targetHeight = mode == DisplayMode::WINDOWED ? WINDOWED_HEIGHT : GetMonitorHeight(monitor);
+        switch (mode) {
+            case DisplayMode::WINDOWED:
+                SetWindowState(FLAG_WINDOW_RESIZABLE);
+                SetWindowSize(WINDOWED_WIDTH, WINDOWED_HEIGHT);
+                break;
+            case DisplayMode::BORDERLESS:
+                ToggleBorderlessWindowed();
+                break;
+            case DisplayMode::EXCLUSIVE:
+                SetWindowSize(GetMonitorWidth(monitor), GetMonitorHeight(monitor));
+                SetWindowState(FLAG_FULLSCREEN_MODE);
+                break;
+        }
+        current = mode;
+    }
+
+    State state = State::STABLE;
+    DisplayMode current = DisplayMode::WINDOWED;
+    DisplayMode requested = DisplayMode::WINDOWED;
+    int width = 0, height = 0;             // Last size seen
+    int layoutWidth = 0, layoutHeight = 0; // Size last reported by Update()
+    int targetWidth = 0, targetHeight = 0; // Size the last mode change should end up at
+    int stableFrames = 0;
+    double switchStart = 0.0;
+    double lastRetry = 0.0;
+    int retries = 0;
+};
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "move_kernels.h"
+#include "raylib.h"
+#include "spatial_grid.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Refers to one entity for as long as it lives. The generation changes when a
+// slot is reused, so a handle to a destroyed entity never aliases a new one.
+struct EntityHandle {
+    uint32_t slot = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool IsNull() const { return slot == UINT32_MAX; }
+};
+
+// Entity storage laid out as structure-of-arrays.
+//
+// Every component lives in its own contiguous array indexed by a dense index
+// in [0, Count()), so systems are plain loops the compiler can vectorize.
+// Destroy() moves the last entity into the hole, which keeps the arrays dense
+// but changes dense indices; hold an EntityHandle and call IndexOf() instead
+// of keeping an index across frames.
+class EntityStore {
+public:
+    // Components, one element per live entity
+    std::vector<float> posX, posY;   // Top-left corner in pixels
+    std::vector<float> prevX, prevY; // Position at the previous simulation tick, for render interpolation
+    std::vector<float> velX, velY;   // Pixels per second
+    std::vector<float> size;         // Square side in pixels
+    std::vector<Color> color;
+
+    uint32_t Count() const { return (uint32_t)posX.size(); }
+
+    void Reserve(uint32_t capacity) {
+        for (auto* array : {&posX, &posY, &prevX, &prevY, &velX, &velY, &size}) array->reserve(capacity);
+        color.reserve(capacity);
+        denseToSlot.reserve(capacity);
+        slots.reserve(capacity);
+    }
+
+    EntityHandle Create(Vector2 position, Vector2 velocity, float entitySize, Color entityColor) {
+        uint32_t slot;
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            slot = (uint32_t)slots.size();
+            slots.push_back(Slot());
+        }
+
+        uint32_t dense = Count();
+        slots[slot].dense = dense;
+        denseToSlot.push_back(slot);
+        posX.push_back(position.x);
+        posY.push_back(position.y);
+        prevX.push_back(position.x);
+        prevY.push_back(position.y);
+        velX.push_back(velocity.x);
+        velY.push_back(velocity.y);
+        size.push_back(entitySize);
+        color.push_back(entityColor);
+        return {slot, slots[slot].generation};
+    }
+
+    // Does nothing for stale or null handles
+    void Destroy(EntityHandle handle) {
+        if (!IsAlive(handle)) return;
+        uint32_t dense = slots[handle.slot].dense;
+        uint32_t last = Count() - 1;
+
+        if (dense != last) {
+            posX[dense] = posX[last];
+            posY[dense] = posY[last];
+            prevX[dense] = prevX[last];
+            prevY[dense] = prevY[last];
+            velX[dense] = velX[last];
+            velY[dense] = velY[last];
+            size[dense] = size[last];
+            color[dense] = color[last];
+            denseToSlot[dense] = denseToSlot[last];
+            slots[denseToSlot[dense]].dense = dense;
+        }
+        for (auto* array : {&posX, &posY, &prevX, &prevY, &velX, &velY, &size}) array->pop_back();
+        color.pop_back();
+        denseToSlot.pop_back();
+
+        slots[handle.slot].generation++;
+        slots[handle.slot].dense = UINT32_MAX;
+        freeSlots.push_back(handle.slot);
+    }
+
+    bool IsAlive(EntityHandle handle) const {
+        return handle.slot < slots.size() && slots[handle.slot].generation == handle.generation &&
+               slots[handle.slot].dense != UINT32_MAX;
+    }
+
+    // Dense index of a live entity, valid until the next Destroy()
+    uint32_t IndexOf(EntityHandle handle) const { return slots[handle.slot].dense; }
+    
+    // Same, for the slot of a live handle (e.g. an id stored in a SpatialGrid)
+    uint32_t IndexOfSlot(uint32_t slot) const { return slots[slot].dense; }
+    
+    // Handle of the entity currently at a dense index
+    EntityHandle HandleAt(uint32_t dense) const {
+        uint32_t slot = denseToSlot[dense];
+        return {slot, slots[slot].generation};
+    }
+
+    void Clear() {
+        for (Slot& slot : slots) {
+            if (slot.dense != UINT32_MAX) {
+                slot.generation++;
+                slot.dense = UINT32_MAX;
+            }
+        }
+        freeSlots.clear();
+        for (uint32_t i = (uint32_t)slots.size(); i > 0; i--) freeSlots.push_back(i - 1);
+        for (auto* array : {&posX, &posY, &prevX, &prevY, &velX, &velY, &size}) array->clear();
+        color.clear();
+        denseToSlot.clear();
+    }
+
+private:
+    struct Slot {
+        uint32_t dense = UINT32_MAX; // UINT32_MAX while free
+        uint32_t generation = 0;
+    };
+
+    std::vector<uint32_t> denseToSlot;
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+};
+
+// Systems: free functions over whole component arrays
+
+// Systems that take a [begin, end) range of dense indices only touch that
+// range, so disjoint ranges can run on different threads.
+
+// Remembers where every entity in the range was before the coming tick
+inline void SnapshotPositions(EntityStore& store, uint32_t begin, uint32_t end) {
+    if (begin >= end) return;
+    memcpy(store.prevX.data() + begin, store.posX.data() + begin, (end - begin) * sizeof(float));
+    memcpy(store.prevY.data() + begin, store.posY.data() + begin, (end - begin) * sizeof(float));
+}
+
+inline void SnapshotPositions(EntityStore& store) { SnapshotPositions(store, 0, store.Count()); }
+
+// Moves every entity by its velocity and keeps it fully inside [0, width] x
+// [0, height]. An entity that hits an edge has that velocity component
+// reversed, so free-moving entities bounce; the player's velocity is set from
+// input before every tick, so for it this is just a clamp.
+inline void MoveEntities(EntityStore& store, float dt, float width, float height, uint32_t begin, uint32_t end) {
+    if (begin >= end) return;
+    // SIMD kernel picked for this CPU at startup (move_kernels.h)
+    move_kernels::GetMoveKernel().fn(store.posX.data() + begin, store.posY.data() + begin, store.velX.data() + begin,
+                                     store.velY.data() + begin, store.size.data() + begin, end - begin, dt, width, height);
+}
+
+inline void MoveEntities(EntityStore& store, float dt, float width, float height) {
+    MoveEntities(store, dt, width, height, 0, store.Count());
+}
+
+// Keeps grid in step with every entity's bounds, keyed by handle slot (which,
+// unlike the dense index, survives Destroy()). Remove destroyed entities from
+// the grid with grid.Remove(handle.slot).
+inline void UpdateEntityGrid(const EntityStore& store, SpatialGrid& grid) {
+    uint32_t count = store.Count();
+    for (uint32_t i = 0; i < count; i++) {
+        grid.Update(store.HandleAt(i).slot, store.posX[i], store.posY[i], store.size[i], store.size[i]);
+    }
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <thread>
+
+// glFinish() is core OpenGL 1.0, exported by the GL library every platform
+// already links for raylib; declared here so no system GL header (and, on
+// Windows, no windows.h next to raylib.h) is needed.
+#if defined(_WIN32)
+extern "C" __declspec(dllimport) void __stdcall glFinish(void);
+#else
+extern "C" void glFinish(void);
+#endif
+
+// Frame pacing for low input latency, and the timestamps to measure it.
+//
+// raylib's EndDrawing() swaps, sleeps out SetTargetFPS() and then polls
+// input, but with VSync the swap itself blocks until the next refresh: a
+// frame that was rendered in 2 ms right after a refresh sits finished for
+// the rest of the interval, and the input it was built from is as old when
+// it reaches the screen. Low-latency mode turns raylib's sleep off and waits
+// at the top of the frame instead, until just enough time is left to sample
+// input, update and render before the next deadline.
+//
+// The queue limit calls glFinish() after the swap, so the driver can't let
+// the CPU run frames ahead of the GPU (each queued frame is another interval
+// of latency), and so "presented" below is close to when the frame really
+// went out rather than when it was queued.
+//
+// Latency is measured from the oldest input event a frame consumed to the end
+// of its swap (plus glFinish with the queue limit on). raylib gives keyboard
+// and mouse events no timestamp, so they count from the poll that delivered
+// them; SDL stamps controller events as they are pumped. Scanout adds up to
+// one more refresh on top. Main thread only.
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr int WORK_HISTORY = 32; // Frames the work estimate looks back over
+    static constexpr double SAFETY_MARGIN = 0.001; // Seconds of slack left before the deadline
+    static constexpr double SPIN_WINDOW = 0.001;   // Final stretch spun instead of slept; sleep overshoots
+
+    void SetLowLatency(bool enabled) { lowLatency = enabled; }
+    bool IsLowLatency() const { return lowLatency; }
+    void SetQueueLimit(bool enabled) { queueLimit = enabled; }
+    bool HasQueueLimit() const { return queueLimit; }
+
+    // Top of the frame, before input is sampled. Sleeps until the latest
+    // point the estimated work still fits before the next deadline; budget is
+    // the frame interval, and <= 0 (uncapped, idle) or an off mode returns at once.
+    // True if it waited.
+    bool WaitForInputDeadline(double budgetSeconds) {
+        if (!lowLatency || budgetSeconds <= 0.0 || !presented) return false;
+        // Deadlines are a budget apart, anchored to the last present when that
+        // came later: with VSync the swap returns at the refresh, which pulls
+        // the schedule onto the display's; after a miss it starts over from there
+        deadline = std::max(deadline, lastPresent) + ToDuration(budgetSeconds);
+        double lead = EstimateWork() + SAFETY_MARGIN;
+        if (lead >= budgetSeconds) return false; // Too slow to gain anything; run straight through
+        Clock::time_point wake = deadline - ToDuration(lead);
+        Clock::time_point now = Clock::now();
+        if (wake <= now) return false;
+        if (wake - now > ToDuration(SPIN_WINDOW)) std::this_thread::sleep_until(wake - ToDuration(SPIN_WINDOW));
+        while (Clock::now() < wake) std::this_thread::yield();
+        return true;
+    }
+
+    // Right after input for the frame was sampled (and raylib polled, in low-latency mode)
+    void MarkInputSampled() {
+        sampleTime = Clock::now();
+        oldestEvent = Clock::time_point::max();
+    }
+
+    // An input event consumed this frame arrived at time; the oldest one counts
+    void NoteInputEvent(Clock::time_point time) { oldestEvent = std::min(oldestEvent, time); }
+
+    // Keyboard or mouse input, which only has the time of the raylib poll that delivered it
+    void NotePolledInput() { NoteInputEvent(presented ? pollTime : sampleTime); }
+
+    // Just before EndDrawing()
+    void MarkSubmit() { submitTime = Clock::now(); }
+
+    // Just after EndDrawing(), which polled raylib on its way out. True if
+    // the frame carried input, with its event-to-present time in latency.
+    bool FinishFrame(Clock::duration& latency) {
+        if (queueLimit) glFinish();
+        Clock::time_point now = Clock::now();
+        pollTime = lastPresent = now;
+        presented = true;
+
+        // Work before the swap varies with the scene, so the worst recent frame
+        // is budgeted. The swap counts from the deadline when it was submitted
+        // early, since until then it was only waiting out the slack left on
+        // purpose; of what remains, the quickest recent time is its own cost and
+        // anything above that was waiting for the refresh
+        workHistory[workIndex] = ToSeconds(submitTime - sampleTime);
+        swapHistory[workIndex] = ToSeconds(now - std::max(submitTime, std::min(deadline, now)));
+        workIndex = (workIndex + 1) % WORK_HISTORY;
+        workCount = std::min(workCount + 1, WORK_HISTORY);
+
+        if (oldestEvent == Clock::time_point::max()) return false;
+        latency = now - oldestEvent;
+        return true;
+    }
+
+    // A late raylib poll (low-latency mode) moves the poll time forward
+    void MarkPolled() { pollTime = Clock::now(); }
+
+private:
+    double EstimateWork() const {
+        double work = 0.0;
+        double swap = workCount > 0 ? swapHistory[0] : 0.0;
+        for (int i = 0; i < workCount; i++) {
+            work = std::max(work, workHistory[i]);
+            swap = std::min(swap, swapHistory[i]);
+        }
+        return work + swap;
+    }
+
+    static Clock::duration ToDuration(double seconds) {
+        return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    }
+    static double ToSeconds(Clock::duration duration) { return std::chrono::duration<double>(duration).count(); }
+
+    bool lowLatency = false;
+    bool queueLimit = false;
+    bool presented = false; // No deadline to aim for before the first frame
+    Clock::time_point lastPresent;
+    Clock::time_point deadline; // The one the current frame aims for
+    Clock::time_point pollTime;
+    Clock::time_point sampleTime;
+    Clock::time_point submitTime;
+    Clock::time_point oldestEvent = Clock::time_point::max();
+    std::array<double, WORK_HISTORY> workHistory{};
+    std::array<double, WORK_HISTORY> swapHistory{};
+    int workIndex = 0;
+    int workCount = 0;
+};
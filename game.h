@@ -0,0 +1,2073 @@
+#pragma once
+
+#include "raylib.h"
+#include "asset_manager.h"
+#include "controllers.h"
+#include "display_mode.h"
+#include "entities.h"
+#include "frame_pacer.h"
+#include "input.h"
+#include "input_log.h"
+#include "job_system.h"
+#include "live_input.h"
+#include "menu_config.h"
+#include "profiler.h"
+#include "quad_batch.h"
+#include "render_scaler.h"
+#include "save_data.h"
+#include "save_writer.h"
+#include "screen_stack.h"
+#include "split_screen.h"
+#include "startup_timeline.h"
+#include "text_renderer.h"
+#include "text_scratch.h"
+#include "trace_export.h"
+#include "voice_pool.h"
+#include <SDL2/SDL.h>
+#include <array>
+#include <vector>
+#include <string>
+#include <memory>
+#include <thread>
+#include <algorithm> // For std::clamp
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <cstdlib> // For getenv
+#include <cmath> // For std::fmod
+
+// Screens; the screen stack holds these, and GetScreenEntry() maps each to its behaviour
+enum class GameState {
+    MENU,
+    PLAYING,
+    SETTINGS,
+    PAUSED
+};
+
+// Fixed UI strings, shared by every screen that shows them
+namespace UiLabel {
+constexpr const char* MOVE_KEYBOARD = "WASD/Arrow Keys: Move";
+constexpr const char* MOVE_CONTROLLER = "Left Stick: Move";
+constexpr const char* PAUSE_KEYBOARD = "ESC: Pause";
+constexpr const char* PAUSE_CONTROLLER = "Start Button: Pause";
+constexpr const char* NAVIGATE_KEYBOARD = "Use mouse to navigate";
+constexpr const char* NAVIGATE_CONTROLLER = "Use controller D-pad to navigate, A to select";
+constexpr const char* INPUT_KEYBOARD = "Input: Keyboard/Mouse";
+constexpr const char* INPUT_CONTROLLER = "Input: Controller";
+} // namespace UiLabel
+
+// Used when resources/menus.cfg is missing or unusable; the shipped file starts as a copy.
+// Format in menu_config.h; item keys are MenuEntry::key, layout values are fractions of the window.
+constexpr const char* DEFAULT_MENU_CONFIG = R"(
+layout button_width 0.2
+layout button_height 0.06
+layout button_spacing 0.02
+layout title_size 0.05
+layout title_y 0.1
+
+menu main "2D Game Template"
+item start_game
+item settings
+item save_game
+item exit
+
+menu settings "Settings"
+item volume
+item toggle_fullscreen
+item render_scale
+item dynamic_resolution
+item low_latency
+item frame_queue_limit
+item split_screen
+item back_to_menu
+
+menu pause "PAUSED"
+item resume
+item save_game
+item main_menu
+)";
+
+class Game;
+
+// Identifies a menu entry independently of its (localizable) label
+enum class MenuId {
+    START_GAME,
+    SETTINGS,
+    SAVE_GAME,
+    EXIT,
+    VOLUME,
+    TOGGLE_FULLSCREEN,
+    RENDER_SCALE,
+    DYNAMIC_RESOLUTION,
+    LOW_LATENCY,
+    FRAME_QUEUE_LIMIT,
+    SPLIT_SCREEN,
+    BACK_TO_MENU,
+    RESUME,
+    MAIN_MENU
+};
+
+enum class WidgetKind {
+    BUTTON, // Activated by click, Enter or A
+    SLIDER, // Stepped with the -/+ buttons, Left/Right or the D-pad; shows its value as a percentage
+    TOGGLE  // Activated like a button; shows On or Off
+};
+
+using MenuAction = void (Game::*)();
+using MenuAdjust = void (Game::*)(float delta);
+using MenuValue = float (Game::*)() const;
+
+// One bindable menu entry; the menu config picks which appear where, Game::LayoutMenus() places them
+struct MenuEntry {
+    const char* key; // Name in the menu config
+    MenuId id;
+    WidgetKind kind;
+    const char* text;
+    MenuAction onActivate; // May be null
+    MenuAdjust onAdjust;   // Sliders only
+    MenuValue getValue;    // Sliders, 0.0-1.0; toggles, 0 or 1
+    float step;            // Sliders only
+};
+
+using ScreenAction = void (Game::*)();
+
+// One screen kind: how it stacks and what runs for it
+struct ScreenEntry {
+    GameState id;
+    uint8_t flags; // ScreenFlag bits
+    ScreenAction update;
+    ScreenAction draw;
+    ProfileZone updateZone;
+    ProfileZone drawZone;
+};
+
+// Menu Item structure
+struct MenuItem {
+    MenuId id;
+    WidgetKind kind;
+    std::string text;
+    MenuAction onActivate;
+    MenuAdjust onAdjust;
+    MenuValue getValue;
+    float step;
+    Rectangle bounds;
+    Color color;
+    Color hoverColor;
+    bool isHovered;
+    bool isSelected; // For controller navigation
+    
+    // Cached layout, filled in by Game::LayoutMenuItem() when bounds or the shown value change
+    std::string label; // Text actually drawn; includes the value for sliders
+    int textSize = 0;
+    Vector2 textPos = {0, 0};
+    Rectangle minusButton = {0, 0, 0, 0}; // Sliders only
+    Rectangle plusButton = {0, 0, 0, 0};
+    
+    MenuItem(const MenuEntry& entry, float x, float y, float width, float height) 
+        : id(entry.id), kind(entry.kind), text(entry.text), onActivate(entry.onActivate), onAdjust(entry.onAdjust),
+          getValue(entry.getValue), step(entry.step), bounds{x, y, width, height}, color{DARKGRAY}, hoverColor{BLUE},
+          isHovered(false), isSelected(false) {}
+};
+
+// Which part of a menu item the mouse is over
+enum class MenuHitPart {
+    BODY,
+    MINUS, // Slider - button
+    PLUS   // Slider + button
+};
+
+struct MenuHit {
+    int item = -1; // Index into the menu, -1 = nothing hit
+    MenuHitPart part = MenuHitPart::BODY;
+};
+
+// Everything that changes how a menu looks; the cached render is reused while it matches
+struct MenuVisualKey {
+    uint64_t itemFlags = 0; // Hovered/selected bits, two per item
+    int layoutVersion = 0;  // Game::menuLayoutVersion when rendered
+    InputMode inputMode = InputMode::KEYBOARD_MOUSE;
+    int width = 0;
+    int height = 0;
+    
+    bool operator==(const MenuVisualKey& other) const {
+        return itemFlags == other.itemFlags && layoutVersion == other.layoutVersion &&
+               inputMode == other.inputMode && width == other.width && height == other.height;
+    }
+};
+
+// Retained render of one menu screen
+struct MenuCache {
+    RenderTexture2D target = {0};
+    MenuVisualKey key;
+    bool valid = false;
+    int titleSize = 0;
+    int titleWidth = 0;
+};
+
+// Construction options, mainly for the headless benchmark
+struct GameOptions {
+    bool headless = false;              // Hidden 1280x720 window, uncapped frame rate, no controllers
+    std::string saveFilePath;           // Empty = game_save.dat next to the executable
+    InputSource* inputSource = nullptr; // nullptr = live raylib input
+    int extraEntities = 0;              // Free-moving entities spawned alongside the player
+    int workerThreads = -1;             // Job system threads, -1 = the saved setting
+    std::string recordInputPath;        // Non-empty = log every frame's input there; else GAME_RECORD_INPUT
+};
+
+// Game class to manage all game logic
+class Game {
+private:
+    TraceRecorder trace;     // Off unless GAME_TRACE is set; see StartTrace()
+    StartupTimeline startup; // Its origin is the start of Game construction
+    bool startupReported = false;
+    bool controllerInitRecorded = false; // SDL_Init can finish after the first frame
+    GameOptions options;
+    ScreenStack<GameState> screens; // Top takes input; see Update() and DrawScreens()
+    int screenWidth;
+    int screenHeight;
+    bool isFullscreen;
+    int targetFPS;
+    bool shouldExit = false;
+    InputMode currentInputMode;
+    int selectedMenuItem = 0;
+    
+    // Menu items
+    std::vector<MenuItem> mainMenuItems;
+    std::vector<MenuItem> settingsMenuItems;
+    std::vector<MenuItem> pauseMenuItems;
+    
+    int menuLayoutVersion = 0; // Bumped whenever any item's label or layout changes
+    
+    // Hit-test index per menu; ids are item index * 3 + MenuHitPart
+    SpatialGrid mainMenuGrid;
+    SpatialGrid settingsMenuGrid;
+    SpatialGrid pauseMenuGrid;
+    
+    // Which entries each menu shows, their titles and the layout fractions; reloaded on edit
+    MenuConfig menuConfig;
+    std::string mainMenuTitle;
+    std::string settingsMenuTitle;
+    std::string pauseMenuTitle;
+    float menuButtonWidth = 0.2f;   // Fractions of the layout width/height
+    float menuButtonHeight = 0.06f;
+    float menuButtonSpacing = 0.02f;
+    float menuTitleSize = 0.05f;
+    float menuTitleY = 0.1f;
+    
+    // Menus are drawn into these only when their look changes, then blitted
+    MenuCache mainMenuCache;
+    MenuCache settingsMenuCache;
+    MenuCache pauseMenuCache;
+    
+    // Game world; the players are entities among (optionally) many. Lane i is
+    // controller slot i; lane 0 also takes the keyboard and always has a player,
+    // the others only while their controller is connected.
+    static constexpr int MAX_PLAYERS = InputState::MAX_PADS;
+    static constexpr Color PLAYER_COLORS[MAX_PLAYERS] = {BLUE, RED, GREEN, ORANGE};
+    static constexpr Color PLAYER_OUTLINES[MAX_PLAYERS] = {DARKBLUE, MAROON, DARKGREEN, BROWN};
+    EntityStore entities;
+    std::array<EntityHandle, MAX_PLAYERS> players{}; // Null for lanes without a player
+    std::array<Vector2, MAX_PLAYERS> laneMovement{}; // This frame's movement input per lane
+    SpatialGrid entityGrid; // Entity bounds keyed by handle slot, updated every tick
+    std::vector<uint32_t> collisionSlots; // CollidePlayer()'s hits, kept between ticks
+    
+    // Worker threads for entity and batch-building loops; raylib and SDL stay on this thread
+    JobSystem jobs;
+    int workerThreads = 0; // Saved setting, 0 = one per extra core
+    static constexpr uint32_t entitiesPerJob = 16384; // Smaller worlds run inline
+    
+    // Fixed-timestep simulation
+    int simTickRate = 60;
+    const int maxCatchUpTicks = 5; // Ticks simulated per frame before the backlog is dropped
+    const float maxFrameDelta = 0.25f; // Longest frame time fed into the accumulator
+    double simAccumulator = 0.0;
+    float simAlpha = 1.0f; // Interpolation factor between each entity's previous and current position
+    
+    // Save data
+    SaveData saveData;
+    std::string saveFilePath;
+    SaveWriter saveWriter;
+    
+    // Input for the current frame
+    InputState input;
+    LiveInputSource liveInput;
+    InputSource* inputSource;
+    InputRecorder inputRecorder; // Sits in front of inputSource while recording; see StartInputRecording()
+    
+    // Popup for save
+    bool showSavePopup = false;
+    float savePopupTimer = 0.0f;
+    const float savePopupDuration = 2.0f; // seconds
+    
+    // SDL2 controllers, opened and closed as they are plugged in
+    ControllerManager controllers;
+    bool showControllerDebug = false;
+    
+#if GAME_PROFILER
+    FrameProfiler profiler;
+    bool showProfiler = false;
+#endif
+    
+    // Track when keyboard/controller navigation was last used
+    bool keyboardControllerNavigationUsed = false;
+    
+    // Wayland detection
+    bool isWayland = false;
+    
+    // Non-blocking mode switches; layout is redone once the new size settles
+    DisplayModeController display;
+    bool exclusiveFullscreen = false; // Fullscreen as a real video mode change instead of borderless
+    bool displaySwitchPending = false;
+    TraceRecorder::Clock::time_point displaySwitchStart;
+    
+    // Last frame of the screens under a transparent one, see DrawScreens()
+    Texture2D screenSnapshot = {};
+    uint32_t snapshotSerial = 0; // Serial of the top layer it covers
+    bool snapshotValid = false;
+    
+    // Formatted text for the frame being drawn; reset at the start of Draw()
+    TextScratch frameText;
+    
+    // Rectangles for entities and menu widgets, drawn in a few batched calls
+    QuadBatch quads;
+    
+    // Menu and HUD text, as glyph quads in the same batch; debug overlays keep DrawText()
+    TextRenderer uiText;
+    uint32_t uiTextVersion = 0; // Last TextRenderer version the menu layout was measured with
+    static constexpr int TEXT_LAYER = 4; // Above the widgets and the world
+    
+    // Optional lower-resolution world pass, upscaled to the window
+    RenderScaler renderScaler;
+    float renderScale = 1.0f;
+    bool dynamicResolution = false;
+    std::chrono::steady_clock::time_point frameStart;
+    double frameCpuSeconds = 0.0; // Last frame up to EndDrawing(), for dynamic resolution
+    
+    // Idle pacing: static menu screens drop to a low frame rate until the next input
+    static constexpr int idleFPS = 20;       // Worst case 50 ms before the first input is seen
+    static constexpr float idleDelay = 0.5f; // Seconds without input or animation before dropping
+    bool idlePacing = true;
+    bool pacingIdle = false;
+    float idleTimer = 0.0f;
+    
+    // Low-latency pacing and the input-to-present measurement
+    FramePacer pacer;
+    bool lowLatency = false;
+    bool frameQueueLimit = false;
+    
+    // One view per player instead of everyone sharing the window
+    SplitScreen splitViews;
+    bool splitScreen = false;
+    
+    float volume = 0.5f;
+    
+    AssetManager assets;
+    AssetHandle volumeChangeSound;
+    VoicePool voices; // UI clicks; the cooldown merges the save click with the adjust click before it
+    static constexpr double assetUploadBudgetMs = 2.0; // Main-thread asset upload time per frame
+    
+    void DetectDisplayServer() {
+        const char* waylandDisplay = getenv("WAYLAND_DISPLAY");
+        const char* x11Display = getenv("DISPLAY");
+        
+        if (waylandDisplay && strlen(waylandDisplay) > 0) {
+            isWayland = true;
+            std::cout << "[INFO] Detected Wayland display server" << std::endl;
+            
+            // Some helpful hints for Wayland users (but don't interfere with SDL)
+            std::cout << "[INFO] Wayland detected - if you experience issues:" << std::endl;
+            std::cout << "[INFO] - Try running with: GDK_BACKEND=x11 ./game" << std::endl;
+            std::cout << "[INFO] - Or: SDL_VIDEODRIVER=x11 ./game" << std::endl;
+        } else if (x11Display && strlen(x11Display) > 0) {
+            isWayland = false;
+            std::cout << "[INFO] Detected X11 display server" << std::endl;
+        } else {
+            std::cout << "[WARNING] Could not detect display server" << std::endl;
+        }
+    }
+    
+    void InitSaveFilePath() {
+        if (!options.saveFilePath.empty()) {
+            saveFilePath = options.saveFilePath;
+            return;
+        }
+        saveFilePath = GetExecutableDir() + "/game_save.dat";
+    }
+    
+    void InitSDL2Controller() {
+        // SDL init and the mapping database load happen on the manager's worker thread
+        std::string mappings = ResolveAssetPath("resources/gamecontrollerdb.txt");
+        controllers.Start(FileExists(mappings.c_str()) ? mappings : "");
+        liveInput.SetControllerManager(&controllers);
+    }
+    
+public:
+    explicit Game(const GameOptions& opts = GameOptions()) 
+           : options(opts), screenWidth(1920), screenHeight(1080), 
+             isFullscreen(true), targetFPS(120), currentInputMode(InputMode::KEYBOARD_MOUSE),
+             inputSource(opts.inputSource ? opts.inputSource : &liveInput), inputRecorder(inputSource), volume(0.5f) {
+        StartTrace();
+        TRACE_SCOPE(trace, "Game()", "startup");
+        ResetScreens(GameState::MENU);
+        // Slow device opens go to other threads first: the audio device here,
+        // SDL on the controller manager's worker, file decoding on the asset
+        // loaders. The window and GL context have to stay on this thread.
+        std::thread audioInit([this] {
+            trace.SetThreadName("audio");
+            PROFILE_ALLOC_TAG(AllocTag::AUDIO);
+            StartupStep step(startup, "InitAudioDevice", "audio");
+            InitAudioDevice();
+        });
+        if (!options.headless) {
+            InitSDL2Controller();
+        }
+        // Decoded in the background; silent until ready, and for good if the file is missing
+        assets.Start();
+        volumeChangeSound = assets.RequestSound("resources/click.wav");
+        
+        {
+            StartupStep step(startup, "Settings and save thread");
+            DetectDisplayServer();
+            InitSaveFilePath();
+            LoadGame();
+            saveWriter.SetTrace(&trace);
+            saveWriter.Start(saveFilePath);
+            jobs.Start(options.workerThreads >= 0 ? options.workerThreads : workerThreads);
+            std::cout << "[INFO] Job system: " << jobs.GetWorkerCount() << " worker threads" << std::endl;
+        }
+        {
+            StartupStep step(startup, "InitWindow");
+            InitializeWindow();
+            quads.Init();
+            uiText.Init(assets, "resources/ui_font.ttf");
+        }
+        StartInputRecording();
+        std::cout << "[INFO] Quad batch: " << (quads.IsInstanced() ? "instanced" : "rlgl") << std::endl;
+        std::cout << "[INFO] Entity movement kernel: " << move_kernels::GetMoveKernel().name << std::endl;
+        {
+            StartupStep step(startup, "Entities and menus");
+            SpawnEntities();
+            SetPlayerPositionFromSave();
+            InitializeMenus();
+        }
+        {
+            // Sounds are only uploaded from RunFrame(), so this is the last point the device can be late
+            StartupStep step(startup, "Wait for audio");
+            audioInit.join();
+        }
+        SetMasterVolume(volume);
+    }
+    
+    ~Game() {
+        {
+            TRACE_SCOPE(trace, "~Game()", "shutdown");
+            {
+                TRACE_SCOPE(trace, "Final save", "shutdown");
+                SaveGame();
+                saveWriter.Stop(); // Flushes the final save without waiting out the coalescing window
+            }
+            {
+                TRACE_SCOPE(trace, "Stop job system", "shutdown");
+                jobs.Stop();
+            }
+            {
+                TRACE_SCOPE(trace, "Unload menus and batch", "shutdown");
+                UnloadMenuCache(mainMenuCache);
+                UnloadMenuCache(settingsMenuCache);
+                UnloadMenuCache(pauseMenuCache);
+                quads.Shutdown();
+                uiText.Shutdown();
+                renderScaler.Unload();
+                splitViews.Unload();
+                if (screenSnapshot.id != 0) UnloadTexture(screenSnapshot);
+            }
+            {
+                TRACE_SCOPE(trace, "Unload assets", "shutdown");
+                voices.Shutdown(); // Aliases go before the sounds they share samples with
+                assets.Stop();
+                assets.UnloadAll();
+            }
+            {
+                TRACE_SCOPE(trace, "Shut down controllers", "shutdown");
+                controllers.Shutdown(); // Closes every pad and quits SDL
+            }
+            {
+                TRACE_SCOPE(trace, "CloseAudioDevice", "shutdown");
+                CloseAudioDevice();
+            }
+        }
+        trace.Write(); // Every thread that records has been joined by now
+    }
+    
+    void Run() {
+        while (!WindowShouldClose() && !shouldExit) {
+            RunFrame();
+        }
+    }
+    
+    // One update + draw; Run() calls this until the window closes
+    void RunFrame() {
+        PROFILE_NEXT_FRAME(profiler);
+        WaitForInputDeadline();
+        frameStart = std::chrono::steady_clock::now();
+        assets.Update(assetUploadBudgetMs);
+        uiText.Update();
+        if (menuConfig.PollReload()) ApplyMenuConfig();
+        if (uiText.GetVersion() != uiTextVersion) LayoutMenus(); // A sharper atlas measures differently
+        Update();
+        Draw();
+        if (!startupReported) ReportStartup();
+        else if (!controllerInitRecorded && controllers.IsInitFinished()) RecordControllerInit(true);
+    }
+    
+    bool ShouldExit() const { return shouldExit; }
+    GameState GetState() const { return screens.Top().id; }
+    int GetWorkerThreadCount() const { return jobs.GetWorkerCount(); }
+    
+#if GAME_PROFILER
+    FrameProfiler& GetProfiler() { return profiler; }
+#endif
+    
+private:
+    // GAME_TRACE=1 writes game_trace.json next to the executable; any other value is the output path
+    void StartTrace() {
+        if (!trace.StartFromEnvironment("GAME_TRACE", GetExecutableDir() + "/game_trace.json")) return;
+        trace.SetThreadName("main");
+        startup.SetTrace(&trace);
+    }
+    
+    // Mouse positions are only comparable at one size, so the log starts once the window exists
+    void StartInputRecording() {
+        std::string path = options.recordInputPath;
+        if (path.empty()) {
+            const char* value = getenv("GAME_RECORD_INPUT");
+            if (value) path = value;
+        }
+        if (path.empty()) return;
+        if (!inputRecorder.Open(path, GetScreenWidth(), GetScreenHeight())) {
+            std::cout << "[WARNING] Could not open input log " << path << std::endl;
+            return;
+        }
+        inputSource = &inputRecorder;
+        std::cout << "[INFO] Recording input to " << path << std::endl;
+    }
+    
+    // Prints the startup timeline once the first frame has been presented
+    void ReportStartup() {
+        startupReported = true;
+        if (controllers.IsInitFinished()) {
+            RecordControllerInit(false);
+        } else if (!options.headless) {
+            std::cout << "[STARTUP] SDL controller init still running at first frame" << std::endl;
+        }
+        startup.Print(StartupTimeline::Clock::now());
+    }
+    
+    // Adds the SDL init step to the timeline (and trace); one that finished after
+    // the timeline was printed gets a line of its own
+    void RecordControllerInit(bool late) {
+        controllerInitRecorded = true;
+        startup.Record("SDL_Init (controllers)", "sdl", controllers.GetStartTime(), controllers.GetReadyTime());
+        if (late) {
+            double tookMs = std::chrono::duration<double, std::milli>(controllers.GetReadyTime() - controllers.GetStartTime()).count();
+            std::cout << "[STARTUP] SDL controller init finished after the first frame; took " << tookMs << " ms" << std::endl;
+        }
+    }
+    
+    void InitializeWindow() {
+        if (options.headless) {
+            // Fixed, hidden window so benchmark numbers are comparable between machines
+            isFullscreen = false;
+            SetConfigFlags(FLAG_WINDOW_HIDDEN);
+        }
+        display.OpenWindow(GetSavedDisplayMode(), "2D Game Template");
+        screenWidth = GetScreenWidth();
+        screenHeight = GetScreenHeight();
+        ApplyTargetFPS();
+        SetExitKey(KEY_NULL);
+    }
+    
+    DisplayMode GetSavedDisplayMode() const {
+        if (!isFullscreen) return DisplayMode::WINDOWED;
+        return exclusiveFullscreen ? DisplayMode::EXCLUSIVE : DisplayMode::BORDERLESS;
+    }
+    
+    // The window settled at a new size: lay out once for it
+    void OnDisplayResized() {
+        TRACE_SCOPE(trace, "Relayout", "display");
+        screenWidth = display.GetLayoutWidth();
+        screenHeight = display.GetLayoutHeight();
+        LayoutMenus();
+        SetPlayerPositionFromSave();
+        snapshotValid = false; // Retaken at the new size the next time it is needed
+    }
+    
+    void SaveGame() {
+        PROFILE_SCOPE(profiler, ProfileZone::SAVE_GAME);
+        PROFILE_ALLOC_TAG(AllocTag::SAVE);
+        TRACE_SCOPE(trace, "SaveGame", "io"); // Snapshot and submit; the write itself is traced on the save thread
+        // Convert absolute position to relative (0.0-1.0)
+        int screenW = GetScreenWidth();
+        int screenH = GetScreenHeight();
+        float playerSize = screenW * 0.03f; // Same as in DrawGame()
+        
+        // Calculate relative position as pure percentage of window size
+        Vector2 playerPos = GetPlayerPos();
+        float relativeX = playerPos.x / screenW;
+        float relativeY = playerPos.y / screenH;
+        
+        // Clamp to valid range (0.0 to 1.0)
+        relativeX = std::clamp(relativeX, 0.0f, 1.0f);
+        relativeY = std::clamp(relativeY, 0.0f, 1.0f);
+        
+        saveData.playerPos = {relativeX, relativeY};
+        saveData.isFullscreen = isFullscreen;
+        saveData.targetFPS = targetFPS;
+        saveData.inputMode = currentInputMode;
+        saveData.volume = volume;
+        saveData.simTickRate = simTickRate;
+        saveData.idlePacing = idlePacing;
+        saveData.workerThreads = workerThreads;
+        saveData.exclusiveFullscreen = exclusiveFullscreen;
+        saveData.renderScale = renderScale;
+        saveData.dynamicResolution = dynamicResolution;
+        saveData.lowLatency = lowLatency;
+        saveData.frameQueueLimit = frameQueueLimit;
+        saveData.splitScreen = splitScreen;
+        
+        // The write happens on the save thread; PollSaveCompletion() reports the result
+        saveWriter.Submit(saveData);
+        
+        voices.Play(assets.GetSound(volumeChangeSound));
+    }
+    
+    void UpdateMainMenu() {
+        UpdateMenu(mainMenuItems);
+    }
+    
+    void UpdateSettingsMenu() {
+        UpdateMenu(settingsMenuItems);
+    }
+    
+    // Paused keeps the last gameplay frame as a snapshot underneath; nothing below the top updates
+    static const ScreenEntry& GetScreenEntry(GameState id) {
+        static const ScreenEntry entries[] = {
+            {GameState::MENU, 0, &Game::UpdateMainMenu, &Game::DrawMainMenu, ProfileZone::UPDATE_MENU, ProfileZone::DRAW_MENU},
+            {GameState::PLAYING, 0, &Game::UpdateGame, &Game::DrawGame, ProfileZone::UPDATE_GAME, ProfileZone::DRAW_GAME},
+            {GameState::SETTINGS, 0, &Game::UpdateSettingsMenu, &Game::DrawSettingsMenu, ProfileZone::UPDATE_MENU, ProfileZone::DRAW_MENU},
+            {GameState::PAUSED, SCREEN_TRANSPARENT, &Game::UpdatePaused, &Game::DrawPaused, ProfileZone::UPDATE_PAUSED, ProfileZone::DRAW_PAUSED},
+        };
+        return entries[(int)id];
+    }
+    
+    void PushScreen(GameState id) {
+        screens.Push(id, GetScreenEntry(id).flags);
+    }
+    
+    void ResetScreens(GameState id) {
+        screens.Reset(id, GetScreenEntry(id).flags);
+    }
+    
+    // Shows the popup once the background write has actually finished
+    void PollSaveCompletion() {
+        bool success = false;
+        if (!saveWriter.PollCompleted(success)) return;
+        
+        if (success) {
+            printf("[SAVE] Position: (%.2f, %.2f), Fullscreen: %s\n", 
+                   saveData.playerPos.x, saveData.playerPos.y, saveData.isFullscreen ? "true" : "false");
+            showSavePopup = true;
+            savePopupTimer = savePopupDuration;
+        } else {
+            printf("[ERROR] Failed to save game\n");
+        }
+    }
+    
+    void LoadGame() {
+        TRACE_SCOPE(trace, "LoadGame", "io");
+        PROFILE_ALLOC_TAG(AllocTag::SAVE);
+        // Out-of-range fields are replaced with defaults while decoding
+        SaveLoadResult result = LoadSaveFile(saveFilePath, saveData);
+        if (result == SaveLoadResult::MISSING) {
+            printf("No save file found, using defaults\n");
+        } else if (result == SaveLoadResult::CORRUPT) {
+            printf("[WARNING] Save file is corrupt or from an older format, using defaults\n");
+        }
+        
+        isFullscreen = saveData.isFullscreen;
+        targetFPS = saveData.targetFPS;
+        currentInputMode = saveData.inputMode;
+        volume = saveData.volume;
+        simTickRate = saveData.simTickRate;
+        idlePacing = saveData.idlePacing;
+        workerThreads = saveData.workerThreads;
+        exclusiveFullscreen = saveData.exclusiveFullscreen;
+        renderScale = saveData.renderScale;
+        dynamicResolution = saveData.dynamicResolution;
+        renderScaler.SetScale(renderScale);
+        renderScaler.SetDynamic(dynamicResolution);
+        lowLatency = saveData.lowLatency;
+        frameQueueLimit = saveData.frameQueueLimit;
+        splitScreen = saveData.splitScreen;
+        pacer.SetLowLatency(lowLatency);
+        pacer.SetQueueLimit(frameQueueLimit);
+    }
+    
+    // The player plus options.extraEntities bouncing squares from a fixed seed, so runs are repeatable
+    void SpawnEntities() {
+        PROFILE_ALLOC_TAG(AllocTag::ENTITIES);
+        int screenW = GetScreenWidth();
+        int screenH = GetScreenHeight();
+        float playerSize = screenW * 0.03f;
+        
+        entities.Clear();
+        entities.Reserve(MAX_PLAYERS + std::max(0, options.extraEntities));
+        players.fill(EntityHandle());
+        players[0] = entities.Create({0, 0}, {0, 0}, playerSize, PLAYER_COLORS[0]);
+        
+        uint32_t seed = 0x9E3779B9u;
+        auto nextRandom = [&seed]() {
+            // xorshift32, 0.0-1.0
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            return (seed & 0xFFFFFF) / (float)0xFFFFFF;
+        };
+        float speed = std::min(screenW, screenH) * 0.25f;
+        float size = std::max(2.0f, screenW * 0.005f);
+        for (int i = 0; i < options.extraEntities; i++) {
+            Vector2 position = {nextRandom() * (screenW - size), nextRandom() * (screenH - size)};
+            Vector2 velocity = {(nextRandom() * 2.0f - 1.0f) * speed, (nextRandom() * 2.0f - 1.0f) * speed};
+            Color color = {(unsigned char)(80 + nextRandom() * 175), (unsigned char)(80 + nextRandom() * 175), 200, 255};
+            entities.Create(position, velocity, size, color);
+        }
+        
+        // Player-sized cells: smaller ones make moving entities change cell more often,
+        // which costs more than the extra candidates a player query has to reject
+        entityGrid.Reset(playerSize * 1.5f, entities.Count());
+        UpdateEntityGrid(entities, entityGrid);
+        collisionSlots.reserve(64);
+    }
+    
+    // Lane 0's player, the one the save keeps
+    Vector2 GetPlayerPos() const {
+        uint32_t index = entities.IndexOf(players[0]);
+        return {entities.posX[index], entities.posY[index]};
+    }
+    
+    void SetPlayerPositionFromSave() {
+        // Convert relative position back to absolute
+        int screenW = GetScreenWidth();
+        int screenH = GetScreenHeight();
+        float playerSize = screenW * 0.03f;
+        
+        // Calculate absolute position from pure percentage, clamped to keep the player fully visible
+        uint32_t index = entities.IndexOf(players[0]);
+        entities.size[index] = playerSize;
+        entities.posX[index] = std::clamp(saveData.playerPos.x * screenW, 0.0f, (float)(screenW - playerSize));
+        entities.posY[index] = std::clamp(saveData.playerPos.y * screenH, 0.0f, (float)(screenH - playerSize));
+        
+        // Nothing to interpolate from after a teleport
+        SnapshotPositions(entities);
+        simAccumulator = 0.0;
+        simAlpha = 1.0f;
+    }
+    
+    // Gives lanes 1-3 a player while their controller is connected: one joins
+    // in its own quarter of the window and leaves when the controller goes
+    void SyncPlayerLanes() {
+        PROFILE_ALLOC_TAG(AllocTag::ENTITIES);
+        int screenW = GetScreenWidth();
+        int screenH = GetScreenHeight();
+        float playerSize = screenW * 0.03f;
+        for (int lane = 1; lane < MAX_PLAYERS; lane++) {
+            bool connected = input.pads[lane].connected;
+            bool alive = entities.IsAlive(players[lane]);
+            if (connected && !alive) {
+                Vector2 position = {screenW * (lane % 2 == 0 ? 0.25f : 0.75f) - playerSize / 2,
+                                    screenH * (lane < 2 ? 0.25f : 0.75f) - playerSize / 2};
+                players[lane] = entities.Create(position, {0, 0}, playerSize, PLAYER_COLORS[lane]);
+                entityGrid.Insert(players[lane].slot, position.x, position.y, playerSize, playerSize);
+                std::cout << "[INFO] Player " << lane + 1 << " joined" << std::endl;
+            } else if (!connected && alive) {
+                entityGrid.Remove(players[lane].slot);
+                entities.Destroy(players[lane]);
+                players[lane] = EntityHandle();
+                std::cout << "[INFO] Player " << lane + 1 << " left" << std::endl;
+            }
+        }
+    }
+    
+    void CheckInputMode() {
+        InputMode previousInputMode = currentInputMode;
+        
+        // Check for SDL2 controller input (events were drained into the snapshot)
+        if (input.controller.activity) {
+            currentInputMode = InputMode::CONTROLLER;
+        }
+        
+        // Check for keyboard/mouse input
+        if (input.IsMouseButtonPressed(MOUSE_LEFT_BUTTON) || 
+            input.IsMouseButtonPressed(MOUSE_RIGHT_BUTTON) || input.IsMouseMoving() ||
+            input.anyKeyPressed) {
+            currentInputMode = InputMode::KEYBOARD_MOUSE;
+        }
+        
+        // Handle cursor visibility when input mode changes
+        if (previousInputMode != currentInputMode) {
+            if (currentInputMode == InputMode::CONTROLLER) {
+                HideCursor();
+            } else {
+                ShowCursor();
+            }
+            
+            // Reset keyboard navigation flag when switching to keyboard/mouse
+            if (currentInputMode == InputMode::KEYBOARD_MOUSE) {
+                keyboardControllerNavigationUsed = false;
+            }
+        }
+        
+        // Handle cursor visibility based on actual input activity
+        if (currentInputMode == InputMode::KEYBOARD_MOUSE) {
+            // Check if mouse is actually moving
+            bool mouseMoving = input.IsMouseMoving();
+            
+            // Show cursor if mouse is moving, hide if using keyboard navigation
+            if (mouseMoving) {
+                ShowCursor();
+                keyboardControllerNavigationUsed = false; // Reset flag when mouse moves
+            } else if (keyboardControllerNavigationUsed) {
+                HideCursor();
+            }
+        }
+    }
+    
+    // Every entry a menu can show, in no particular order; dispatch goes through the bound actions
+    static const MenuEntry* FindMenuEntry(const char* key, size_t length) {
+        static const MenuEntry entries[] = {
+            {"start_game", MenuId::START_GAME, WidgetKind::BUTTON, "Start Game", &Game::StartGame, nullptr, nullptr, 0.0f},
+            {"settings", MenuId::SETTINGS, WidgetKind::BUTTON, "Settings", &Game::OpenSettings, nullptr, nullptr, 0.0f},
+            {"save_game", MenuId::SAVE_GAME, WidgetKind::BUTTON, "Save Game", &Game::SaveGame, nullptr, nullptr, 0.0f},
+            {"exit", MenuId::EXIT, WidgetKind::BUTTON, "Exit", &Game::ExitGame, nullptr, nullptr, 0.0f},
+            {"volume", MenuId::VOLUME, WidgetKind::SLIDER, "Volume", nullptr, &Game::AdjustVolume, &Game::GetVolume, 0.05f},
+            {"toggle_fullscreen", MenuId::TOGGLE_FULLSCREEN, WidgetKind::BUTTON, "Toggle Fullscreen", &Game::ToggleFullscreenMode, nullptr, nullptr, 0.0f},
+            {"render_scale", MenuId::RENDER_SCALE, WidgetKind::SLIDER, "Render Scale", nullptr, &Game::AdjustRenderScale, &Game::GetRenderScale, 0.05f},
+            {"dynamic_resolution", MenuId::DYNAMIC_RESOLUTION, WidgetKind::TOGGLE, "Dynamic Resolution", &Game::ToggleDynamicResolution, nullptr, &Game::GetDynamicResolution, 0.0f},
+            {"low_latency", MenuId::LOW_LATENCY, WidgetKind::TOGGLE, "Low Latency", &Game::ToggleLowLatency, nullptr, &Game::GetLowLatency, 0.0f},
+            {"frame_queue_limit", MenuId::FRAME_QUEUE_LIMIT, WidgetKind::TOGGLE, "Limit Frame Queue", &Game::ToggleFrameQueueLimit, nullptr, &Game::GetFrameQueueLimit, 0.0f},
+            {"split_screen", MenuId::SPLIT_SCREEN, WidgetKind::TOGGLE, "Split Screen", &Game::ToggleSplitScreen, nullptr, &Game::GetSplitScreen, 0.0f},
+            {"back_to_menu", MenuId::BACK_TO_MENU, WidgetKind::BUTTON, "Back to Menu", &Game::ReturnToMainMenu, nullptr, nullptr, 0.0f},
+            {"resume", MenuId::RESUME, WidgetKind::BUTTON, "Resume", &Game::ResumeGame, nullptr, nullptr, 0.0f},
+            {"main_menu", MenuId::MAIN_MENU, WidgetKind::BUTTON, "Main Menu", &Game::ReturnToMainMenu, nullptr, nullptr, 0.0f},
+        };
+        for (const MenuEntry& entry : entries) {
+            if (strlen(entry.key) == length && memcmp(entry.key, key, length) == 0) return &entry;
+        }
+        return nullptr;
+    }
+    
+    // Loads the menu config (the built-in one if the file is missing or unusable),
+    // builds the menus from it and starts watching the file for edits
+    void InitializeMenus() {
+        PROFILE_ALLOC_TAG(AllocTag::UI);
+        std::string path = ResolveAssetPath("resources/menus.cfg");
+        bool fromFile = menuConfig.LoadFile(path) && CheckMenuConfig();
+        if (!fromFile) {
+            printf("[INFO] Using the built-in menus; %s is missing or unusable\n", path.c_str());
+            menuConfig.LoadFromMemory(DEFAULT_MENU_CONFIG, strlen(DEFAULT_MENU_CONFIG), "built-in menus");
+        }
+        BuildMenus();
+        menuConfig.Watch(); // Even without a usable file, so creating or fixing one takes effect
+    }
+    
+    // After a reload: rebuilds the menus, or goes back to the previous config if the new one can't be used
+    void ApplyMenuConfig() {
+        PROFILE_ALLOC_TAG(AllocTag::UI);
+        if (!CheckMenuConfig()) {
+            menuConfig.Revert();
+            return;
+        }
+        printf("[INFO] Menu config reloaded\n");
+        BuildMenus();
+    }
+    
+    // Every menu the game shows exists, has 1-32 items (the menu cache key's limit), and names only known entries
+    bool CheckMenuConfig() const {
+        for (const char* name : {"main", "settings", "pause"}) {
+            const MenuConfig::Menu* menu = menuConfig.FindMenu(name);
+            if (!menu || menu->itemCount == 0 || menu->itemCount > 32) {
+                printf("[WARNING] Menu config: menu '%s' is missing or has no items (or more than 32)\n", name);
+                return false;
+            }
+            for (uint32_t i = 0; i < menu->itemCount; i++) {
+                MenuConfig::Text key = menuConfig.GetItem(*menu, i).key;
+                if (!FindMenuEntry(menuConfig.GetText(key), key.length)) {
+                    printf("[WARNING] Menu config: unknown item '%.*s' in menu '%s'\n", (int)key.length, menuConfig.GetText(key), name);
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+    
+    // Builds the menu items from the checked config; LayoutMenus() positions them
+    void BuildMenus() {
+        auto buildMenu = [this](std::vector<MenuItem>& items, std::string& title, const char* name) {
+            const MenuConfig::Menu& menu = *menuConfig.FindMenu(name);
+            title.assign(menuConfig.GetText(menu.title), menu.title.length);
+            items.clear();
+            for (uint32_t i = 0; i < menu.itemCount; i++) {
+                const MenuConfig::Item& item = menuConfig.GetItem(menu, i);
+                items.emplace_back(*FindMenuEntry(menuConfig.GetText(item.key), item.key.length), 0.0f, 0.0f, 0.0f, 0.0f);
+                if (item.label.length > 0) items.back().text.assign(menuConfig.GetText(item.label), item.label.length);
+            }
+        };
+        buildMenu(mainMenuItems, mainMenuTitle, "main");
+        buildMenu(settingsMenuItems, settingsMenuTitle, "settings");
+        buildMenu(pauseMenuItems, pauseMenuTitle, "pause");
+        selectedMenuItem = 0; // Item counts may have changed
+        
+        menuButtonWidth = std::clamp(menuConfig.GetLayout("button_width", 0.2f), 0.01f, 1.0f);
+        menuButtonHeight = std::clamp(menuConfig.GetLayout("button_height", 0.06f), 0.01f, 1.0f);
+        menuButtonSpacing = std::clamp(menuConfig.GetLayout("button_spacing", 0.02f), 0.0f, 1.0f);
+        menuTitleSize = std::clamp(menuConfig.GetLayout("title_size", 0.05f), 0.01f, 1.0f);
+        menuTitleY = std::clamp(menuConfig.GetLayout("title_y", 0.1f), 0.0f, 1.0f);
+        LayoutMenus();
+    }
+    
+    // Positions every menu item for the current layout size and rebuilds the hit-test grids
+    void LayoutMenus() {
+        PROFILE_ALLOC_TAG(AllocTag::UI);
+        int winW = display.GetLayoutWidth();
+        int winH = display.GetLayoutHeight();
+        uiTextVersion = uiText.GetVersion();
+        
+        // Bake the atlases for this size's text now rather than on first draw
+        for (float size : {winH * menuTitleSize, winH * 0.04f, winH * 0.03f, winH * 0.025f, winH * 0.02f}) uiText.Prepare(size);
+        
+        // Scale button size relative to window size
+        float buttonWidth = winW * menuButtonWidth;
+        float buttonHeight = winH * menuButtonHeight;
+        float buttonSpacing = winH * menuButtonSpacing;
+        
+        float centerX = winW / 2.0f - buttonWidth / 2.0f;
+        for (auto* menu : {&mainMenuItems, &settingsMenuItems, &pauseMenuItems}) {
+            int count = (int)menu->size();
+            float totalHeight = count * buttonHeight + (count - 1) * buttonSpacing;
+            float startY = winH / 2.0f - totalHeight / 2.0f;
+            for (int i = 0; i < count; i++) {
+                MenuItem& item = (*menu)[i];
+                item.bounds = {centerX, startY + i * (buttonHeight + buttonSpacing), buttonWidth, buttonHeight};
+                LayoutMenuItem(item);
+            }
+        }
+        mainMenuCache.valid = false;
+        settingsMenuCache.valid = false;
+        pauseMenuCache.valid = false;
+        
+        // Cells about one button tall, so each button spans a single row
+        auto buildGrid = [&](SpatialGrid& grid, const std::vector<MenuItem>& items) {
+            grid.Reset(buttonHeight + buttonSpacing, (uint32_t)items.size() * 3);
+            for (size_t i = 0; i < items.size(); i++) {
+                const MenuItem& item = items[i];
+                uint32_t base = (uint32_t)i * 3;
+                grid.Insert(base + (uint32_t)MenuHitPart::BODY, item.bounds.x, item.bounds.y, item.bounds.width, item.bounds.height);
+                if (item.kind == WidgetKind::SLIDER) {
+                    const Rectangle& minus = item.minusButton;
+                    const Rectangle& plus = item.plusButton;
+                    grid.Insert(base + (uint32_t)MenuHitPart::MINUS, minus.x, minus.y, minus.width, minus.height);
+                    grid.Insert(base + (uint32_t)MenuHitPart::PLUS, plus.x, plus.y, plus.width, plus.height);
+                }
+            }
+        };
+        buildGrid(mainMenuGrid, mainMenuItems);
+        buildGrid(settingsMenuGrid, settingsMenuItems);
+        buildGrid(pauseMenuGrid, pauseMenuItems);
+    }
+    
+    const SpatialGrid& MenuGridFor(const std::vector<MenuItem>& menuItems) const {
+        if (&menuItems == &settingsMenuItems) return settingsMenuGrid;
+        if (&menuItems == &pauseMenuItems) return pauseMenuGrid;
+        return mainMenuGrid;
+    }
+    
+    // The item under point; a slider's -/+ button wins over the slider body
+    MenuHit HitTestMenu(const std::vector<MenuItem>& menuItems, Vector2 point) const {
+        MenuHit hit;
+        MenuGridFor(menuItems).QueryPoint(point.x, point.y, [&hit](uint32_t id) {
+            MenuHitPart part = (MenuHitPart)(id % 3);
+            if (hit.item < 0 || part != MenuHitPart::BODY) {
+                hit.item = (int)(id / 3);
+                hit.part = part;
+            }
+        });
+        return hit;
+    }
+    
+    // Measures and positions an item's text; call again when its label changes
+    void LayoutMenuItem(MenuItem& item) {
+        PROFILE_ALLOC_TAG(AllocTag::UI);
+        item.textSize = item.bounds.height * 0.5f;
+        
+        if (item.kind == WidgetKind::SLIDER) {
+            item.label = TextFormat("%s: %d%%", item.text.c_str(), (int)roundf((this->*item.getValue)() * 100));
+            float btnSize = item.bounds.height * 0.7f;
+            item.minusButton = {item.bounds.x + 8, item.bounds.y + item.bounds.height/2 - btnSize/2, btnSize, btnSize};
+            item.plusButton = {item.bounds.x + item.bounds.width - btnSize - 8, item.bounds.y + item.bounds.height/2 - btnSize/2, btnSize, btnSize};
+        } else if (item.kind == WidgetKind::TOGGLE) {
+            item.label = TextFormat("%s: %s", item.text.c_str(), (this->*item.getValue)() > 0.5f ? "On" : "Off");
+        } else {
+            item.label = item.text;
+        }
+        
+        int textWidth = uiText.Measure(item.label.c_str(), item.textSize);
+        item.textPos = {item.bounds.x + item.bounds.width / 2 - textWidth / 2,
+                        item.bounds.y + item.bounds.height / 2 - item.textSize / 2};
+        menuLayoutVersion++;
+    }
+    
+    void ActivateMenuItem(MenuItem& item) {
+        if (item.onActivate) (this->*item.onActivate)();
+        if (item.kind == WidgetKind::TOGGLE) LayoutMenuItem(item); // Label shows the new state
+    }
+    
+    // direction is -1 or +1; does nothing for buttons
+    void AdjustMenuItem(MenuItem& item, int direction) {
+        if (item.kind != WidgetKind::SLIDER || !item.onAdjust) return;
+        (this->*item.onAdjust)(direction * item.step);
+        LayoutMenuItem(item);
+    }
+    
+    float GetVolume() const { return volume; }
+    float GetRenderScale() const { return renderScale; }
+    float GetDynamicResolution() const { return dynamicResolution ? 1.0f : 0.0f; }
+    float GetLowLatency() const { return lowLatency ? 1.0f : 0.0f; }
+    float GetFrameQueueLimit() const { return frameQueueLimit ? 1.0f : 0.0f; }
+    float GetSplitScreen() const { return splitScreen ? 1.0f : 0.0f; }
+    
+    void AdjustRenderScale(float delta) {
+        renderScale = std::clamp(roundf((renderScale + delta) * 20.0f) / 20.0f, RenderScaler::MIN_SCALE, RenderScaler::MAX_SCALE);
+        renderScaler.SetScale(renderScale);
+        SaveGame();
+    }
+    
+    void ToggleDynamicResolution() {
+        dynamicResolution = !dynamicResolution;
+        renderScaler.SetDynamic(dynamicResolution);
+        SaveGame();
+    }
+    
+    void ToggleLowLatency() {
+        lowLatency = !lowLatency;
+        pacer.SetLowLatency(lowLatency);
+        ApplyTargetFPS();
+        SaveGame();
+    }
+    
+    void ToggleFrameQueueLimit() {
+        frameQueueLimit = !frameQueueLimit;
+        pacer.SetQueueLimit(frameQueueLimit);
+        SaveGame();
+    }
+    
+    void ToggleSplitScreen() {
+        splitScreen = !splitScreen;
+        SaveGame();
+    }
+    
+    // Deadline dynamic resolution measures frames against; 0 while there is none to miss
+    double GetFrameBudget() const {
+        if (options.headless || pacingIdle || targetFPS <= 0) return 0.0;
+        double budget = 1.0 / targetFPS;
+        int refreshRate = GetMonitorRefreshRate(GetCurrentMonitor());
+        if (IsWindowState(FLAG_VSYNC_HINT) && refreshRate > 0) budget = std::max(budget, 1.0 / refreshRate);
+        return budget;
+    }
+    
+    // One volume step up or down from any input device
+    void AdjustVolume(float delta) {
+        volume = std::clamp(volume + delta, 0.0f, 1.0f);
+        volume = roundf(volume * 20.0f) / 20.0f;
+        SetMasterVolume(volume);
+        {
+            PROFILE_ALLOC_TAG(AllocTag::AUDIO);
+            voices.Play(assets.GetSound(volumeChangeSound));
+        }
+        SaveGame();
+    }
+    
+    void Update() {
+        if (display.Update()) OnDisplayResized();
+        if (displaySwitchPending && !display.IsSettling()) {
+            displaySwitchPending = false;
+            trace.Complete("Display mode switch", "display", displaySwitchStart, TraceRecorder::Clock::now());
+        }
+        {
+            PROFILE_SCOPE(profiler, ProfileZone::INPUT);
+            inputSource->Capture(input);
+            pacer.MarkInputSampled();
+            NoteInputEvents();
+            CheckInputMode();
+        }
+        
+        // Toggle controller debug overlay
+        if (input.IsKeyPressed(KEY_F1)) {
+            showControllerDebug = !showControllerDebug;
+        }
+        
+#if GAME_PROFILER
+        // Toggle frame profiler overlay
+        if (input.IsKeyPressed(KEY_F2)) {
+            showProfiler = !showProfiler;
+        }
+#endif
+        
+        // Update save popup timer
+        PollSaveCompletion();
+        if (showSavePopup) {
+            savePopupTimer -= input.frameTime;
+            if (savePopupTimer <= 0.0f) {
+                showSavePopup = false;
+            }
+        }
+        
+        // The top screen, plus any under it that keep updating while covered. Screen code is
+        // charged to UI; the world, saves and sounds it triggers retag themselves
+        PROFILE_ALLOC_TAG(AllocTag::UI);
+        uint32_t stackVersion = screens.GetVersion();
+        for (int i = 0; i < screens.Size(); i++) {
+            if (i != screens.Size() - 1 && !screens[i].Has(SCREEN_UPDATE_COVERED)) continue;
+            const ScreenEntry& screen = GetScreenEntry(screens[i].id);
+            {
+                PROFILE_SCOPE(profiler, screen.updateZone);
+                (this->*screen.update)();
+            }
+            if (screens.GetVersion() != stackVersion) break; // A push or pop; the new stack updates from next frame
+        }
+        
+        UpdateFramePacing();
+    }
+    
+    // True when this frame would look exactly like the last one without input
+    bool IsScreenStatic() const {
+        if (screens.Top().id == GameState::PLAYING) return false;
+        if (showSavePopup || display.IsSettling() || showControllerDebug) return false;
+        if (assets.GetPendingCount() > 0) return false; // Keep uploading at full rate
+#if GAME_PROFILER
+        if (showProfiler) return false;
+#endif
+        if (IsWindowResized()) return false;
+        
+        bool anyInput = input.keysDown.any() || input.anyKeyPressed || input.mousePressed.any() ||
+                        input.IsMouseMoving() || input.controller.activity ||
+                        input.controller.buttonsDown.any() || input.controller.stickDown.any();
+        return !anyInput;
+    }
+    
+    // Drops to idleFPS once the screen has been static for idleDelay, and
+    // returns to targetFPS on the first frame with input or animation. raylib
+    // queues input while it sleeps, so nothing is lost, only delayed.
+    void UpdateFramePacing() {
+        if (!idlePacing || options.headless) return;
+        
+        if (IsScreenStatic()) {
+            idleTimer += input.frameTime;
+        } else {
+            idleTimer = 0.0f;
+        }
+        
+        bool wantIdle = idleTimer >= idleDelay;
+        if (wantIdle != pacingIdle) {
+            pacingIdle = wantIdle;
+            ApplyTargetFPS();
+        }
+    }
+    
+    // raylib's own sleep after the swap; low-latency mode sleeps before input instead, except while idle
+    void ApplyTargetFPS() {
+        if (options.headless) SetTargetFPS(0);
+        else if (pacingIdle) SetTargetFPS(idleFPS);
+        else SetTargetFPS(lowLatency ? 0 : targetFPS);
+    }
+    
+    // Low-latency mode: sleeps out the spare part of the frame, then polls, so the frame starts from fresh input
+    void WaitForInputDeadline() {
+        if (!pacer.IsLowLatency() || options.headless) return;
+        {
+            PROFILE_SCOPE(profiler, ProfileZone::PACE_WAIT);
+            pacer.WaitForInputDeadline(GetFrameBudget());
+        }
+        liveInput.PollLate();
+        pacer.MarkPolled();
+    }
+    
+    // Gives the pacer the arrival time of the oldest input event in this frame's input
+    void NoteInputEvents() {
+        bool polledEvent = input.anyKeyPressed || input.keysPressed.any() || input.mousePressed.any() || input.IsMouseMoving();
+        if (polledEvent) pacer.NotePolledInput();
+        if (input.controller.firstEventTime != 0) {
+            // SDL stamps events in milliseconds on its own clock; their age carries over to ours
+            Uint32 age = SDL_GetTicks() - input.controller.firstEventTime;
+            pacer.NoteInputEvent(FramePacer::Clock::now() - std::chrono::milliseconds(age));
+        }
+    }
+    
+    void UpdateMenu(std::vector<MenuItem>& menuItems) {
+        // Handle Escape key to go back from settings to main menu
+        if (screens.Top().id == GameState::SETTINGS) {
+            bool escapePressed = input.IsKeyPressed(KEY_ESCAPE);
+            bool backButtonPressed = input.controller.IsButtonPressed(SDL_CONTROLLER_BUTTON_BACK);
+            bool bButtonPressed = input.controller.IsButtonPressed(SDL_CONTROLLER_BUTTON_B);
+            
+            if (escapePressed || backButtonPressed || bButtonPressed) {
+                ReturnToMainMenu();
+                return;
+            }
+        }
+        
+        for (auto& item : menuItems) {
+            item.isSelected = false;
+            item.isHovered = false; // Clear hover states initially
+        }
+        
+        if (currentInputMode == InputMode::KEYBOARD_MOUSE) {
+            Vector2 mousePos = input.mousePosition;
+            bool mouseUsed = false;
+            bool mouseHovering = false;
+            bool keyboardUsed = false;
+            
+            // Check for keyboard navigation first
+            if (input.IsKeyPressed(KEY_DOWN) || input.IsKeyPressed(KEY_S) || 
+                input.IsKeyPressed(KEY_UP) || input.IsKeyPressed(KEY_W) ||
+                input.IsKeyPressed(KEY_ENTER) || input.IsKeyPressed(KEY_SPACE)) {
+                keyboardControllerNavigationUsed = true;
+                keyboardUsed = true;
+            }
+            
+            // Only set hover states if not using keyboard navigation
+            if (!keyboardControllerNavigationUsed) {
+                MenuHit hit = HitTestMenu(menuItems, mousePos);
+                if (hit.item >= 0) {
+                    MenuItem& item = menuItems[hit.item];
+                    item.isHovered = true;
+                    mouseHovering = true;
+                    if (input.IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+                        // Slider mouse +/-
+                        if (hit.part == MenuHitPart::MINUS) AdjustMenuItem(item, -1);
+                        if (hit.part == MenuHitPart::PLUS) AdjustMenuItem(item, 1);
+                        ActivateMenuItem(item);
+                        mouseUsed = true;
+                    }
+                }
+            }
+            
+            // Slider adjustment with keyboard (A/D/Left/Right) when selected
+            if (selectedMenuItem >= 0 && selectedMenuItem < (int)menuItems.size()) {
+                bool left = input.IsKeyPressed(KEY_LEFT) || input.IsKeyPressed(KEY_A);
+                bool right = input.IsKeyPressed(KEY_RIGHT) || input.IsKeyPressed(KEY_D);
+                if (left) {
+                    AdjustMenuItem(menuItems[selectedMenuItem], -1);
+                }
+                if (right) {
+                    AdjustMenuItem(menuItems[selectedMenuItem], 1);
+                }
+            }
+            
+            // Show keyboard selection if keyboard was recently used, regardless of mouse position
+            if (keyboardControllerNavigationUsed) {
+                // Up/Down arrow or W/S
+                if (input.IsKeyPressed(KEY_DOWN) || input.IsKeyPressed(KEY_S)) {
+                    selectedMenuItem = (selectedMenuItem + 1) % menuItems.size();
+                }
+                if (input.IsKeyPressed(KEY_UP) || input.IsKeyPressed(KEY_W)) {
+                    selectedMenuItem = (selectedMenuItem - 1 + menuItems.size()) % menuItems.size();
+                }
+                // Select current item
+                if (selectedMenuItem >= 0 && selectedMenuItem < menuItems.size()) {
+                    menuItems[selectedMenuItem].isSelected = true;
+                }
+                // Enter to select
+                if (input.IsKeyPressed(KEY_ENTER) || input.IsKeyPressed(KEY_SPACE)) {
+                    if (selectedMenuItem >= 0 && selectedMenuItem < menuItems.size()) {
+                        ActivateMenuItem(menuItems[selectedMenuItem]);
+                    }
+                }
+            }
+            
+            // Reset keyboard navigation flag if mouse is used
+            if (mouseUsed) {
+                keyboardControllerNavigationUsed = false;
+            }
+        } else {
+            // SDL2 controller navigation
+            const ControllerState& pad = input.controller;
+            if (pad.connected) {
+                keyboardControllerNavigationUsed = true;
+                
+                // Clear all hover states when controller is used
+                for (auto& item : menuItems) {
+                    item.isHovered = false;
+                }
+                
+                // Check for D-pad navigation (one press at a time)
+                if (pad.IsButtonPressed(SDL_CONTROLLER_BUTTON_DPAD_UP) || 
+                    input.IsKeyPressed(KEY_UP) ||
+                    pad.IsStickPressed(StickDirection::UP)) {
+                    selectedMenuItem = (selectedMenuItem - 1 + menuItems.size()) % menuItems.size();
+                }
+                
+                if (pad.IsButtonPressed(SDL_CONTROLLER_BUTTON_DPAD_DOWN) || 
+                    input.IsKeyPressed(KEY_DOWN) ||
+                    pad.IsStickPressed(StickDirection::DOWN)) {
+                    selectedMenuItem = (selectedMenuItem + 1) % menuItems.size();
+                }
+                
+                if (selectedMenuItem >= 0 && selectedMenuItem < menuItems.size()) {
+                    menuItems[selectedMenuItem].isSelected = true;
+                }
+                
+                // Handle selection with A button
+                if (pad.IsButtonPressed(SDL_CONTROLLER_BUTTON_A) || 
+                    input.IsKeyPressed(KEY_ENTER)) {
+                    if (selectedMenuItem >= 0 && selectedMenuItem < menuItems.size()) {
+                        ActivateMenuItem(menuItems[selectedMenuItem]);
+                    }
+                }
+                
+                // Slider adjustment with controller (one jump per press)
+                if (selectedMenuItem >= 0 && selectedMenuItem < (int)menuItems.size()) {
+                    if (pad.IsButtonPressed(SDL_CONTROLLER_BUTTON_DPAD_LEFT)) {
+                        AdjustMenuItem(menuItems[selectedMenuItem], -1);
+                    }
+                    if (pad.IsButtonPressed(SDL_CONTROLLER_BUTTON_DPAD_RIGHT)) {
+                        AdjustMenuItem(menuItems[selectedMenuItem], 1);
+                    }
+                }
+            }
+        }
+    }
+    
+    // Menu actions, bound to items in InitializeMenus()
+    void StartGame() {
+        SetPlayerPositionFromSave();
+        ResetScreens(GameState::PLAYING);
+    }
+    
+    void OpenSettings() {
+        PushScreen(GameState::SETTINGS);
+    }
+    
+    void ExitGame() {
+        SaveGame(); // Auto-save on exit
+        shouldExit = true;
+    }
+    
+    void ResumeGame() {
+        screens.Pop();
+    }
+    
+    void ReturnToMainMenu() {
+        SaveGame(); // Auto-save when going back to menu
+        ResetScreens(GameState::MENU);
+    }
+    
+    // Starts the switch and returns; Update() relays out once the new size settles
+    void ToggleFullscreenMode() {
+        isFullscreen = !isFullscreen;
+        display.Request(GetSavedDisplayMode());
+        displaySwitchPending = true;
+        displaySwitchStart = TraceRecorder::Clock::now();
+        std::cout << "[INFO] Switching to " << GetDisplayModeName(GetSavedDisplayMode()) << std::endl;
+    }
+    
+    void UpdateGame() {
+        // Handle input
+        if (input.IsKeyPressed(KEY_ESCAPE) || 
+            input.controller.IsButtonPressed(SDL_CONTROLLER_BUTTON_START)) {
+            PushScreen(GameState::PAUSED);
+        }
+        
+        renderScaler.UpdateDynamic(input.frameTime, frameCpuSeconds, GetFrameBudget());
+        
+        SyncPlayerLanes();
+        for (int lane = 0; lane < MAX_PLAYERS; lane++) laneMovement[lane] = ReadMovementInput(lane);
+        
+        if (simTickRate <= 0) {
+            // Variable timestep: one simulation step per rendered frame
+            StepWorld(input.frameTime);
+            simAlpha = 1.0f;
+            return;
+        }
+        
+        // Fixed timestep: input is sampled once per frame and applied to every tick
+        const double tickDelta = 1.0 / simTickRate;
+        simAccumulator += std::min(input.frameTime, maxFrameDelta);
+        
+        int ticks = 0;
+        while (simAccumulator >= tickDelta && ticks < maxCatchUpTicks) {
+            StepWorld((float)tickDelta);
+            simAccumulator -= tickDelta;
+            ticks++;
+        }
+        
+        // After a long stall drop the backlog instead of spiralling, keeping the tick phase
+        if (simAccumulator >= tickDelta) {
+            simAccumulator = std::fmod(simAccumulator, tickDelta);
+        }
+        
+        simAlpha = (float)(simAccumulator / tickDelta);
+    }
+    
+    // Lane 0 follows the chosen input mode; the other lanes only have their controller
+    Vector2 ReadMovementInput(int lane) {
+        Vector2 movement = {0, 0};
+        const ControllerState& pad = input.pads[lane];
+        
+        if (lane == 0 && currentInputMode == InputMode::KEYBOARD_MOUSE) {
+            if (input.IsKeyDown(KEY_W) || input.IsKeyDown(KEY_UP)) movement.y -= 1;
+            if (input.IsKeyDown(KEY_S) || input.IsKeyDown(KEY_DOWN)) movement.y += 1;
+            if (input.IsKeyDown(KEY_A) || input.IsKeyDown(KEY_LEFT)) movement.x -= 1;
+            if (input.IsKeyDown(KEY_D) || input.IsKeyDown(KEY_RIGHT)) movement.x += 1;
+        } else {
+            // SDL2 controller movement
+            if (pad.connected) {
+                Sint16 leftX = pad.GetAxisRaw(SDL_CONTROLLER_AXIS_LEFTX);
+                Sint16 leftY = pad.GetAxisRaw(SDL_CONTROLLER_AXIS_LEFTY);
+                
+                // Convert to float and apply deadzone
+                float deadzone = 8000.0f; // SDL2 uses -32768 to 32767
+                if (abs(leftX) > deadzone) {
+                    movement.x = leftX / 32767.0f;
+                }
+                if (abs(leftY) > deadzone) {
+                    movement.y = leftY / 32767.0f;
+                }
+            }
+        }
+        
+        // Normalize diagonal movement
+        if (movement.x != 0 && movement.y != 0) {
+            movement.x *= 0.707f;
+            movement.y *= 0.707f;
+        }
+        
+        return movement;
+    }
+    
+    // One simulation tick for every entity, every player's moved in the same pass
+    void StepWorld(float dt) {
+        PROFILE_SCOPE(profiler, ProfileZone::SIMULATE);
+        PROFILE_ALLOC_TAG(AllocTag::ENTITIES);
+        // Calculate relative movement speed based on window size
+        int screenW = GetScreenWidth();
+        int screenH = GetScreenHeight();
+        float baseSpeed = std::min(screenW, screenH) * 0.5f;
+        
+        // Player velocities come from their lane's input each tick; everything else keeps its own
+        for (int lane = 0; lane < MAX_PLAYERS; lane++) {
+            if (!entities.IsAlive(players[lane])) continue;
+            uint32_t index = entities.IndexOf(players[lane]);
+            entities.velX[index] = laneMovement[lane].x * baseSpeed;
+            entities.velY[index] = laneMovement[lane].y * baseSpeed;
+            entities.size[index] = screenW * 0.03f;
+        }
+        
+        // Both systems only touch their own range, so chunks of the world move in parallel
+        float width = (float)screenW;
+        float height = (float)screenH;
+        jobs.ParallelFor(entities.Count(), entitiesPerJob, [&](uint32_t begin, uint32_t end) {
+            SnapshotPositions(entities, begin, end);
+            MoveEntities(entities, dt, width, height, begin, end);
+        });
+        UpdateEntityGrid(entities, entityGrid);
+        for (EntityHandle player : players) {
+            if (entities.IsAlive(player)) CollidePlayer(player);
+        }
+    }
+    
+    bool IsPlayerSlot(uint32_t slot) const {
+        for (EntityHandle player : players) {
+            if (player.slot == slot) return true;
+        }
+        return false;
+    }
+    
+    // Pushes every entity touching the player out along the shallower axis and sends it away;
+    // players pass through each other
+    void CollidePlayer(EntityHandle player) {
+        uint32_t playerIndex = entities.IndexOf(player);
+        float px = entities.posX[playerIndex];
+        float py = entities.posY[playerIndex];
+        float ps = entities.size[playerIndex];
+        int screenW = GetScreenWidth();
+        int screenH = GetScreenHeight();
+        
+        // Moving an entity can change its cell, so collect the hits before pushing any
+        collisionSlots.clear();
+        entityGrid.QueryRect(px, py, ps, ps, [&](uint32_t slot) {
+            if (!IsPlayerSlot(slot)) collisionSlots.push_back(slot);
+        });
+        for (uint32_t slot : collisionSlots) {
+            uint32_t i = entities.IndexOfSlot(slot);
+            float s = entities.size[i];
+            float dx = (entities.posX[i] + s / 2) - (px + ps / 2);
+            float dy = (entities.posY[i] + s / 2) - (py + ps / 2);
+            float overlapX = (s + ps) / 2 - std::fabs(dx);
+            float overlapY = (s + ps) / 2 - std::fabs(dy);
+            if (overlapX < overlapY) {
+                entities.posX[i] = std::clamp(entities.posX[i] + (dx < 0 ? -overlapX : overlapX), 0.0f, screenW - s);
+                entities.velX[i] = dx < 0 ? -std::fabs(entities.velX[i]) : std::fabs(entities.velX[i]);
+            } else {
+                entities.posY[i] = std::clamp(entities.posY[i] + (dy < 0 ? -overlapY : overlapY), 0.0f, screenH - s);
+                entities.velY[i] = dy < 0 ? -std::fabs(entities.velY[i]) : std::fabs(entities.velY[i]);
+            }
+            entityGrid.Update(slot, entities.posX[i], entities.posY[i], s, s); // So the next player's query sees it here
+        }
+    }
+    
+    void UpdatePaused() {
+        const ControllerState& pad = input.controller;
+        if (input.IsKeyPressed(KEY_ESCAPE) || 
+            pad.IsButtonPressed(SDL_CONTROLLER_BUTTON_START) ||
+            pad.IsButtonPressed(SDL_CONTROLLER_BUTTON_B)) {
+            ResumeGame();
+        }
+        if (input.IsKeyPressed(KEY_M) || 
+            pad.IsButtonPressed(SDL_CONTROLLER_BUTTON_BACK)) {
+            ResetScreens(GameState::MENU);
+        }
+        
+        for (auto& item : pauseMenuItems) {
+            item.isSelected = false;
+            item.isHovered = false; // Clear hover states initially
+        }
+        
+        if (currentInputMode == InputMode::KEYBOARD_MOUSE) {
+            Vector2 mousePos = input.mousePosition;
+            bool mouseUsed = false;
+            bool mouseHovering = false;
+            bool keyboardUsed = false;
+            
+            // Check for keyboard navigation first
+            if (input.IsKeyPressed(KEY_DOWN) || input.IsKeyPressed(KEY_S) || 
+                input.IsKeyPressed(KEY_UP) || input.IsKeyPressed(KEY_W) ||
+                input.IsKeyPressed(KEY_ENTER) || input.IsKeyPressed(KEY_SPACE)) {
+                keyboardControllerNavigationUsed = true;
+                keyboardUsed = true;
+            }
+            
+            // Only set hover states if not using keyboard navigation
+            if (!keyboardControllerNavigationUsed) {
+                MenuHit hit = HitTestMenu(pauseMenuItems, mousePos);
+                if (hit.item >= 0) {
+                    MenuItem& item = pauseMenuItems[hit.item];
+                    item.isHovered = true;
+                    mouseHovering = true;
+                    if (input.IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+                        ActivateMenuItem(item);
+                        mouseUsed = true;
+                    }
+                }
+            }
+            
+            // Show keyboard selection if keyboard was recently used, regardless of mouse position
+            if (keyboardControllerNavigationUsed) {
+                // Up/Down arrow or W/S
+                if (input.IsKeyPressed(KEY_DOWN) || input.IsKeyPressed(KEY_S)) {
+                    selectedMenuItem = (selectedMenuItem + 1) % pauseMenuItems.size();
+                }
+                if (input.IsKeyPressed(KEY_UP) || input.IsKeyPressed(KEY_W)) {
+                    selectedMenuItem = (selectedMenuItem - 1 + pauseMenuItems.size()) % pauseMenuItems.size();
+                }
+                // Select current item
+                if (selectedMenuItem >= 0 && selectedMenuItem < pauseMenuItems.size()) {
+                    pauseMenuItems[selectedMenuItem].isSelected = true;
+                }
+                // Enter to select
+                if (input.IsKeyPressed(KEY_ENTER) || input.IsKeyPressed(KEY_SPACE)) {
+                    if (selectedMenuItem >= 0 && selectedMenuItem < pauseMenuItems.size()) {
+                        ActivateMenuItem(pauseMenuItems[selectedMenuItem]);
+                    }
+                }
+            }
+            
+            // Reset keyboard navigation flag if mouse is used
+            if (mouseUsed) {
+                keyboardControllerNavigationUsed = false;
+            }
+        } else {
+            if (pad.connected) {
+                keyboardControllerNavigationUsed = true;
+                
+                // Clear all hover states when controller is used
+                for (auto& item : pauseMenuItems) {
+                    item.isHovered = false;
+                }
+                
+                if (pad.IsButtonPressed(SDL_CONTROLLER_BUTTON_DPAD_UP) || 
+                    input.IsKeyPressed(KEY_UP) ||
+                    pad.IsStickPressed(StickDirection::UP)) {
+                    selectedMenuItem = (selectedMenuItem - 1 + pauseMenuItems.size()) % pauseMenuItems.size();
+                }
+                if (pad.IsButtonPressed(SDL_CONTROLLER_BUTTON_DPAD_DOWN) || 
+                    input.IsKeyPressed(KEY_DOWN) ||
+                    pad.IsStickPressed(StickDirection::DOWN)) {
+                    selectedMenuItem = (selectedMenuItem + 1) % pauseMenuItems.size();
+                }
+                
+                if (selectedMenuItem >= 0 && selectedMenuItem < pauseMenuItems.size()) {
+                    pauseMenuItems[selectedMenuItem].isSelected = true;
+                }
+                
+                if (pad.IsButtonPressed(SDL_CONTROLLER_BUTTON_A) || 
+                    input.IsKeyPressed(KEY_ENTER)) {
+                    if (selectedMenuItem >= 0 && selectedMenuItem < pauseMenuItems.size()) {
+                        ActivateMenuItem(pauseMenuItems[selectedMenuItem]);
+                    }
+                }
+            }
+        }
+    }
+    
+    void Draw() {
+        PROFILE_ALLOC_TAG(AllocTag::UI);
+        frameText.Reset();
+        quads.ResetStats();
+        uiText.ResetStats();
+        BeginDrawing();
+        ClearBackground({30, 30, 46, 255});
+        ClearBackground({30, 30, 46, 255}); // Catppuccin Mocha background (#1e1e2e)
+        
+        DrawScreens();
+        
+        // Draw save popup if needed
+        if (showSavePopup) {
+            int winW = GetScreenWidth();
+            int winH = GetScreenHeight();
+            int popupFontSize = winH * 0.025f;
+            const char* popupText = "Game Saved!";
+            int textWidth = uiText.Measure(popupText, popupFontSize);
+            float alpha = (savePopupTimer / savePopupDuration);
+            Color popupColor = Fade(GREEN, alpha);
+            uiText.Draw(quads, popupText, {(float)(winW - textWidth - 30), 30}, popupFontSize, popupColor, TEXT_LAYER);
+            quads.Flush();
+        }
+        
+        // Draw controller debug overlay if enabled
+        if (showControllerDebug) {
+            DrawControllerDebugOverlay();
+        }
+        
+#if GAME_PROFILER
+        // Draw frame profiler overlay if enabled
+        if (showProfiler) {
+            DrawProfilerOverlay();
+        }
+#endif
+        
+        frameCpuSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - frameStart).count();
+        pacer.MarkSubmit();
+        PROFILE_SCOPE(profiler, ProfileZone::END_DRAWING);
+        EndDrawing();
+        FramePacer::Clock::duration latency;
+        if (pacer.FinishFrame(latency)) PROFILE_INPUT_LATENCY(profiler, latency);
+    }
+
+    // Draws the visible screens bottom-up. A covered screen without
+    // SCREEN_DRAW_COVERED is drawn live once, read back into screenSnapshot,
+    // and from then on the snapshot stands in for it and everything under it,
+    // until it is popped or the window size changes.
+    void DrawScreens() {
+        int top = screens.Size() - 1;
+        int first = screens.GetFirstVisible();
+        int frozen = -1; // Highest visible, covered screen that is kept as a snapshot
+        for (int i = first; i < top; i++) {
+            if (!screens[i].Has(SCREEN_DRAW_COVERED)) frozen = i;
+        }
+        
+        int start = first;
+        if (frozen >= 0 && snapshotValid && screens[frozen].serial == snapshotSerial) {
+            PROFILE_SCOPE(profiler, GetScreenEntry(screens.Top().id).drawZone);
+            Rectangle source = {0, 0, (float)screenSnapshot.width, (float)screenSnapshot.height};
+            DrawTexturePro(screenSnapshot, source, {0, 0, (float)GetScreenWidth(), (float)GetScreenHeight()}, {0, 0}, 0.0f, WHITE);
+            start = frozen + 1;
+        }
+        for (int i = start; i <= top; i++) {
+            const ScreenEntry& screen = GetScreenEntry(screens[i].id);
+            {
+                PROFILE_SCOPE(profiler, screen.drawZone);
+                (this->*screen.draw)();
+            }
+            if (i == frozen) CaptureScreenSnapshot(screens[i].serial);
+        }
+    }
+    
+    // Copies what has been drawn this frame so far; one GPU readback when a screen is first covered
+    void CaptureScreenSnapshot(uint32_t serial) {
+        rlDrawRenderBatchActive(); // Batched geometry has to reach the framebuffer first
+        Image image = LoadImageFromScreen();
+        if (screenSnapshot.id != 0 && screenSnapshot.width == image.width && screenSnapshot.height == image.height) {
+            UpdateTexture(screenSnapshot, image.data);
+        } else {
+            if (screenSnapshot.id != 0) UnloadTexture(screenSnapshot);
+            screenSnapshot = LoadTextureFromImage(image);
+        }
+        UnloadImage(image);
+        snapshotSerial = serial;
+        snapshotValid = screenSnapshot.id != 0;
+    }
+    
+    void DrawMainMenu() {
+        DrawMenu(mainMenuItems, mainMenuTitle.c_str(), mainMenuCache);
+    }
+    
+    void DrawSettingsMenu() {
+        DrawMenu(settingsMenuItems, settingsMenuTitle.c_str(), settingsMenuCache);
+    }
+    
+    void DrawMenu(const std::vector<MenuItem>& menuItems, const char* title, MenuCache& cache) {
+        // Layout size, not window size: mid-switch the cache keeps its old size instead of being reallocated every frame
+        int winW = display.GetLayoutWidth();
+        int winH = display.GetLayoutHeight();
+        
+        MenuVisualKey key;
+        for (size_t i = 0; i < menuItems.size() && i < 32; ++i) {
+            key.itemFlags |= (uint64_t)menuItems[i].isHovered << (2 * i);
+            key.itemFlags |= (uint64_t)menuItems[i].isSelected << (2 * i + 1);
+        }
+        key.layoutVersion = menuLayoutVersion;
+        key.inputMode = currentInputMode;
+        key.width = winW;
+        key.height = winH;
+        
+        // Re-render only when something visible changed
+        if (!cache.valid || !(cache.key == key)) {
+            if (cache.target.texture.width != winW || cache.target.texture.height != winH) {
+                UnloadMenuCache(cache);
+                cache.target = LoadRenderTexture(winW, winH);
+            }
+            cache.titleSize = winH * menuTitleSize;
+            cache.titleWidth = uiText.Measure(title, cache.titleSize); // Cached string; changes when a sharper atlas arrives
+            BeginTextureMode(cache.target);
+            ClearBackground(BLANK);
+            DrawMenuContents(menuItems, title, cache);
+            EndTextureMode();
+            cache.key = key;
+            cache.valid = true;
+        }
+        
+        // Render textures are stored bottom-up, hence the negative source height
+        DrawTextureRec(cache.target.texture, {0, 0, (float)winW, -(float)winH}, {0, 0}, WHITE);
+    }
+    
+    void DrawMenuContents(const std::vector<MenuItem>& menuItems, const char* title, const MenuCache& cache) {
+        int winW = display.GetLayoutWidth();
+        int winH = display.GetLayoutHeight();
+        
+        uiText.Draw(quads, title, {(float)(winW / 2 - cache.titleWidth / 2), winH * menuTitleY}, cache.titleSize, DARKGRAY, TEXT_LAYER);
+        
+        // Widget shapes and labels share one flush; the labels' layer puts them on top
+        for (size_t i = 0; i < menuItems.size(); ++i) {
+            const auto& item = menuItems[i];
+            Color drawColor = item.color;
+            if (item.isHovered || item.isSelected) {
+                drawColor = item.hoverColor;
+            }
+            quads.AddRect(item.bounds, drawColor);
+            quads.AddRectLines(item.bounds, 2, BLACK);
+            
+            // Slider: - and + buttons
+            if (item.kind == WidgetKind::SLIDER) {
+                Rectangle minusBtn = item.minusButton;
+                Rectangle plusBtn = item.plusButton;
+                float btnSize = minusBtn.width;
+                quads.AddRect(minusBtn, GRAY);
+                quads.AddRect(plusBtn, GRAY);
+                quads.AddRectLines(minusBtn, 2, BLACK);
+                quads.AddRectLines(plusBtn, 2, BLACK);
+                // Draw - and + symbols
+                int symbolSize = btnSize * 0.6f;
+                int minusX = minusBtn.x + btnSize/2 - symbolSize/2;
+                int minusY = minusBtn.y + btnSize/2 - symbolSize/8;
+                quads.AddRect({(float)minusX, (float)minusY, (float)symbolSize, (float)(symbolSize/4)}, BLACK);
+                int plusX = plusBtn.x + btnSize/2 - symbolSize/2;
+                int plusY = plusBtn.y + btnSize/2 - symbolSize/8;
+                quads.AddRect({(float)plusX, (float)plusY, (float)symbolSize, (float)(symbolSize/4)}, BLACK);
+                quads.AddRect({(float)(plusX + symbolSize/2 - symbolSize/8), (float)(plusY - symbolSize/2 + symbolSize/8),
+                               (float)(symbolSize/4), (float)symbolSize}, BLACK);
+            }
+        }
+        
+        for (const auto& item : menuItems) {
+            uiText.Draw(quads, item.label.c_str(), item.textPos, item.textSize, WHITE, TEXT_LAYER);
+        }
+        
+        // Scale instruction text
+        int instructionSize = winH * 0.02f; // 2% of window height
+        const char* instructionText = currentInputMode == InputMode::KEYBOARD_MOUSE ? 
+            UiLabel::NAVIGATE_KEYBOARD : UiLabel::NAVIGATE_CONTROLLER;
+        uiText.Draw(quads, instructionText, {10, (float)(winH - instructionSize - 10)}, instructionSize, GRAY, TEXT_LAYER);
+        
+        // Show current input mode
+        const char* inputModeText = currentInputMode == InputMode::KEYBOARD_MOUSE ? 
+            UiLabel::INPUT_KEYBOARD : UiLabel::INPUT_CONTROLLER;
+        uiText.Draw(quads, inputModeText, {winW - uiText.Measure(inputModeText, instructionSize) - 10,
+                                           (float)(winH - instructionSize - 10)}, instructionSize, GRAY, TEXT_LAYER);
+        quads.Flush();
+    }
+    
+    void UnloadMenuCache(MenuCache& cache) {
+        if (cache.target.id != 0) {
+            UnloadRenderTexture(cache.target);
+        }
+        cache = MenuCache();
+    }
+    
+    void DrawGame() {
+        int winW = GetScreenWidth();
+        int winH = GetScreenHeight();
+        
+        const Color background = {30, 30, 46, 255};
+        
+        // Every entity blended between its last two simulation ticks; the players are drawn again on top.
+        // The quads are written straight into the batch, in parallel for large worlds.
+        uint32_t count = entities.Count();
+        QuadBatch::QuadSpan span = quads.AppendRects(count);
+        jobs.ParallelFor(count, entitiesPerJob, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++) {
+                float x = entities.prevX[i] + (entities.posX[i] - entities.prevX[i]) * simAlpha;
+                float y = entities.prevY[i] + (entities.posY[i] - entities.prevY[i]) * simAlpha;
+                span.rects[i] = {x, y, entities.size[i], entities.size[i]};
+                span.colors[i] = entities.color[i];
+            }
+        });
+        
+        // Player size is 3% of window width
+        Vector2 renderPos = {0, 0}; // Lane 0's, for the HUD
+        std::array<Vector2, MAX_PLAYERS> viewFocus;
+        std::array<int, MAX_PLAYERS> viewLane;
+        int viewCount = 0;
+        for (int lane = 0; lane < MAX_PLAYERS; lane++) {
+            if (!entities.IsAlive(players[lane])) continue;
+            uint32_t index = entities.IndexOf(players[lane]);
+            float playerSize = entities.size[index];
+            Vector2 position = {entities.prevX[index] + (entities.posX[index] - entities.prevX[index]) * simAlpha,
+                                entities.prevY[index] + (entities.posY[index] - entities.prevY[index]) * simAlpha};
+            if (lane == 0) renderPos = position;
+            Rectangle playerRect = {position.x, position.y, playerSize, playerSize};
+            quads.AddRect(playerRect, entities.color[index], 1);
+            quads.AddRectLines(playerRect, 1, PLAYER_OUTLINES[lane], 1);
+            viewFocus[viewCount] = {position.x + playerSize / 2, position.y + playerSize / 2};
+            viewLane[viewCount++] = lane;
+        }
+        
+        if (splitScreen && viewCount > 1) {
+            // The same batch drawn into every player's view, then all views composited
+            // in the flush below together with the HUD
+            splitViews.Begin(viewCount, winW, winH, renderScaler.GetScale(), renderScaler.GetCurrentScale());
+            for (int view = 0; view < viewCount; view++) {
+                splitViews.BeginView(view, viewFocus[view], (float)winW, (float)winH, background);
+                quads.Submit();
+                splitViews.EndView();
+            }
+            quads.Clear();
+            splitViews.Composite(quads, 0, DARKGRAY);
+            float labelSize = winH * 0.025f;
+            for (int view = 0; view < viewCount; view++) {
+                static const char* labels[MAX_PLAYERS] = {"P1", "P2", "P3", "P4"};
+                Rectangle viewport = splitViews.GetViewport(view);
+                float inset = winW * 0.01f;
+                uiText.Draw(quads, labels[viewLane[view]], {viewport.x + inset, viewport.y + viewport.height - inset - labelSize},
+                            labelSize, PLAYER_COLORS[viewLane[view]], TEXT_LAYER);
+            }
+        } else {
+            // The world goes through the render scaler; the HUD text below is drawn at full resolution
+            renderScaler.Begin(winW, winH, background);
+            quads.Flush();
+            renderScaler.End(winW, winH);
+        }
+        
+        // Scale UI text sizes relative to window
+        int titleSize = winH * 0.04f; // 4% of window height
+        int subtitleSize = winH * 0.025f; // 2.5% of window height
+        int infoSize = winH * 0.02f; // 2% of window height
+        
+        // Scale UI positioning relative to window
+        int margin = winW * 0.01f; // 1% of window width
+        int lineSpacing = winH * 0.03f; // 3% of window height
+        
+        float left = (float)margin;
+        uiText.Draw(quads, "Game Running", {left, left}, titleSize, DARKGRAY, TEXT_LAYER);
+        
+        bool keyboard = currentInputMode == InputMode::KEYBOARD_MOUSE;
+        uiText.Draw(quads, keyboard ? UiLabel::MOVE_KEYBOARD : UiLabel::MOVE_CONTROLLER, 
+                    {left, (float)(margin + lineSpacing)}, subtitleSize, GRAY, TEXT_LAYER);
+        uiText.Draw(quads, keyboard ? UiLabel::PAUSE_KEYBOARD : UiLabel::PAUSE_CONTROLLER, 
+                    {left, (float)(margin + lineSpacing * 2)}, subtitleSize, GRAY, TEXT_LAYER);
+        
+        // Draw player position with scaled text
+        const char* posText = frameText.Format("Player: (%d, %d)", (int)renderPos.x, (int)renderPos.y);
+        uiText.Draw(quads, posText, {left, (float)(margin + lineSpacing * 3)}, infoSize, GRAY, TEXT_LAYER);
+        
+        // Show current input mode
+        const char* inputModeText = keyboard ? UiLabel::INPUT_KEYBOARD : UiLabel::INPUT_CONTROLLER;
+        uiText.Draw(quads, inputModeText, {winW - uiText.Measure(inputModeText, infoSize) - margin, left},
+                    infoSize, GRAY, TEXT_LAYER);
+        quads.Flush();
+    }
+    
+    void DrawPaused() {
+        int winW = GetScreenWidth();
+        int winH = GetScreenHeight();
+        
+        // Draw semi-transparent overlay
+        quads.AddRect({0, 0, (float)winW, (float)winH}, {0, 0, 0, 128});
+        quads.Flush();
+        
+        // Draw pause menu
+        DrawMenu(pauseMenuItems, pauseMenuTitle.c_str(), pauseMenuCache);
+    }
+    
+    void DrawControllerDebugOverlay() {
+        int y = 40;
+        int fontSize = 18;
+        DrawRectangle(20, 20, 700, 400, Fade(BLACK, 0.7f));
+        DrawText("[Controller Debug - F1 to hide]", 30, y, fontSize, YELLOW);
+        y += fontSize + 8;
+        
+        const ControllerState& pad = input.controller;
+        if (!controllers.IsReady()) {
+            DrawText("Controller: SDL2 initializing...", 30, y, fontSize, YELLOW);
+        } else if (pad.connected) {
+            DrawText(TextFormat("Controllers: %d connected", controllers.GetConnectedCount()), 30, y, fontSize, GREEN);
+            y += fontSize + 2;
+            
+            for (int i = 0; i < ControllerManager::MAX_CONTROLLERS; i++) {
+                const ControllerManager::Slot& slot = controllers.GetSlot(i);
+                if (!slot.IsConnected()) continue;
+                bool active = &slot.state == &controllers.GetActiveState();
+                DrawText(TextFormat("%s Slot %d: %s", active ? ">" : " ", i, slot.name.c_str()), 
+                        50, y, fontSize, active ? WHITE : LIGHTGRAY);
+                y += fontSize;
+            }
+            y += 2;
+            
+            // Show axis values
+            Sint16 leftX = pad.GetAxisRaw(SDL_CONTROLLER_AXIS_LEFTX);
+            Sint16 leftY = pad.GetAxisRaw(SDL_CONTROLLER_AXIS_LEFTY);
+            DrawText(TextFormat("Left Stick: (%d, %d)", leftX, leftY), 50, y, fontSize, LIGHTGRAY);
+            y += fontSize;
+            
+            // Show button states
+            bool aButton = pad.IsButtonDown(SDL_CONTROLLER_BUTTON_A);
+            bool bButton = pad.IsButtonDown(SDL_CONTROLLER_BUTTON_B);
+            bool startButton = pad.IsButtonDown(SDL_CONTROLLER_BUTTON_START);
+            DrawText(TextFormat("Buttons - A: %s, B: %s, Start: %s", 
+                               aButton ? "YES" : "NO", bButton ? "YES" : "NO", startButton ? "YES" : "NO"), 
+                    50, y, fontSize, LIGHTGRAY);
+        } else {
+            DrawText("Controller: Not connected", 30, y, fontSize, RED);
+        }
+    }
+    
+#if GAME_PROFILER
+    void DrawProfilerOverlay() {
+        // Sits to the right of the controller debug overlay
+        int x = 740;
+        int y = 40;
+        int fontSize = 18;
+        int rowHeight = fontSize + 2;
+        int zoneCount = (int)ProfileZone::COUNT;
+        int tagCount = FrameProfiler::ALLOC_TAG_COUNT;
+        DrawRectangle(x - 10, 20, 520, 60 + (zoneCount + tagCount + 8) * rowHeight, Fade(BLACK, 0.7f));
+        DrawText(TextFormat("[Frame Profiler - F2 to hide] last %d frames", 
+                           FrameProfiler::HISTORY_FRAMES), x, y, fontSize, YELLOW);
+        y += fontSize + 8;
+        
+        DrawText("Zone", x, y, fontSize, GRAY);
+        DrawText("avg ms", x + 200, y, fontSize, GRAY);
+        DrawText("p99 ms", x + 300, y, fontSize, GRAY);
+        DrawText("max ms", x + 400, y, fontSize, GRAY);
+        y += rowHeight;
+        
+        for (int i = 0; i < zoneCount; i++) {
+            ProfileZone zone = (ProfileZone)i;
+            FrameProfiler::ZoneStats stats = profiler.GetStats(zone);
+            Color color = zone == ProfileZone::FRAME ? WHITE : LIGHTGRAY;
+            DrawText(GetProfileZoneName(zone), x, y, fontSize, color);
+            DrawText(TextFormat("%.2f", stats.avgMs), x + 200, y, fontSize, color);
+            DrawText(TextFormat("%.2f", stats.p99Ms), x + 300, y, fontSize, color);
+            DrawText(TextFormat("%.2f", stats.maxMs), x + 400, y, fontSize, color);
+            y += rowHeight;
+        }
+        
+        // Steady state should read 0; anything else is a heap allocation in the frame loop
+        FrameProfiler::FrameRecord latest;
+        uint32_t lastAllocations = profiler.GetLatestFrame(latest) ? latest.allocations : 0;
+        uint32_t maxAllocations = profiler.GetMaxAllocations();
+        DrawText(frameText.Format("Allocations/frame: %u (max %u)", lastAllocations, maxAllocations), 
+                x, y, fontSize, maxAllocations == 0 ? GREEN : ORANGE);
+        y += rowHeight;
+        
+        // Quad batch work for this frame so far; the menu screens only draw when their cache is rebuilt
+        const QuadBatch::Stats& batch = quads.GetStats();
+        DrawText(frameText.Format("Batch (%s): %d draws, %d verts, %d quads", quads.IsInstanced() ? "instanced" : "rlgl",
+                                  batch.drawCalls, batch.vertices, batch.quads),
+                x, y, fontSize, LIGHTGRAY);
+        y += rowHeight;
+        
+        // Layout work shows up as shaped strings; a steady screen should only hit the cache
+        const TextRenderer::Stats& text = uiText.GetStats();
+        DrawText(frameText.Format("UI text: %d glyphs, %d cached, %d shaped", text.glyphs, text.cached, text.shaped),
+                x, y, fontSize, text.shaped > 0 ? ORANGE : LIGHTGRAY);
+        y += rowHeight;
+        
+        DrawText(frameText.Format("Render scale: %d%%%s", (int)roundf(renderScaler.GetCurrentScale() * 100.0f),
+                                  renderScaler.IsDynamic() ? " (dynamic)" : ""),
+                x, y, fontSize, renderScaler.GetCurrentScale() < renderScale ? ORANGE : LIGHTGRAY);
+        y += rowHeight;
+        
+        // Input event to the end of the swap, over the frames in the history that had input
+        FrameProfiler::LatencyStats latency = profiler.GetInputLatencyStats();
+        DrawText(frameText.Format("Input latency%s: p50 %.1f  p95 %.1f  p99 %.1f ms", pacer.IsLowLatency() ? " (low)" : "",
+                                  latency.p50Ms, latency.p95Ms, latency.p99Ms),
+                x, y, fontSize, latency.samples > 0 ? LIGHTGRAY : GRAY);
+        y += rowHeight + 8;
+        
+        // Operator new by subsystem, every thread; allocations per frame over the history
+        DrawText("Heap", x, y, fontSize, GRAY);
+        DrawText("/frame", x + 120, y, fontSize, GRAY);
+        DrawText("live KB", x + 220, y, fontSize, GRAY);
+        DrawText("peak KB", x + 320, y, fontSize, GRAY);
+        DrawText("total", x + 420, y, fontSize, GRAY);
+        y += rowHeight;
+        for (int i = 0; i <= tagCount; i++) {
+            AllocTag tag = (AllocTag)i;
+            AllocTagStats heap = GetAllocTagStats(tag);
+            bool total = tag == AllocTag::COUNT;
+            float perFrame = 0.0f;
+            for (int t = 0; t < tagCount; t++) {
+                if (total || t == i) perFrame += profiler.GetAllocRate((AllocTag)t).meanPerFrame;
+            }
+            Color color = total ? WHITE : perFrame > 0.0f ? ORANGE : LIGHTGRAY;
+            DrawText(total ? "All" : GetAllocTagName(tag), x, y, fontSize, color);
+            DrawText(frameText.Format("%.2f", perFrame), x + 120, y, fontSize, color);
+            DrawText(frameText.Format("%.1f", heap.liveBytes / 1024.0), x + 220, y, fontSize, color);
+            DrawText(frameText.Format("%.1f", heap.peakBytes / 1024.0), x + 320, y, fontSize, color);
+            DrawText(frameText.Format("%llu", (unsigned long long)heap.allocations), x + 420, y, fontSize, color);
+            y += rowHeight;
+        }
+        
+        // What malloc holds beyond operator new's blocks: raylib, SDL, the audio device and libc
+        int64_t mallocBytes = GetMallocHeapBytes();
+        if (mallocBytes >= 0) {
+            int64_t untracked = mallocBytes - GetAllocTagStats(AllocTag::COUNT).liveBytes;
+            DrawText(frameText.Format("malloc heap: %.1f MB, %.1f MB outside operator new",
+                                      mallocBytes / (1024.0 * 1024.0), untracked / (1024.0 * 1024.0)),
+                    x, y, fontSize, LIGHTGRAY);
+        } else {
+            DrawText("malloc heap: not reported on this platform", x, y, fontSize, GRAY);
+        }
+    }
+#endif
+};
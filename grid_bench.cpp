@@ -0,0 +1,154 @@
+// Micro-benchmark for the spatial hash grid (spatial_grid.h): times updates
+// and point, box and pair queries as the object count grows, next to a linear
+// scan doing the same query, and checks both find the same objects.
+//
+// Usage: grid_bench [--objects N] [--queries N]
+//
+// Needs neither raylib nor a display.
+
+#include "spatial_grid.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+static const float WORLD_W = 1280.0f;
+static const float WORLD_H = 720.0f;
+static const float OBJECT_SIZE = 6.0f; // Like game_bench --entities at 1280x720
+static const float QUERY_SIZE = 38.4f; // Player-sized query box
+static const float CELL_SIZE = 57.6f;  // What the game picks at 1280x720
+
+struct Objects {
+    std::vector<float> x, y, vx, vy;
+};
+
+static uint32_t seed = 0x9E3779B9u;
+static float NextRandom() {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return (seed & 0xFFFFFF) / (float)0xFFFFFF;
+}
+
+static Objects MakeObjects(uint32_t count) {
+    Objects o;
+    for (uint32_t i = 0; i < count; i++) {
+        o.x.push_back(NextRandom() * (WORLD_W - OBJECT_SIZE));
+        o.y.push_back(NextRandom() * (WORLD_H - OBJECT_SIZE));
+        o.vx.push_back((NextRandom() * 2.0f - 1.0f) * 180.0f);
+        o.vy.push_back((NextRandom() * 2.0f - 1.0f) * 180.0f);
+    }
+    return o;
+}
+
+// One 60 Hz tick of bouncing movement, then the matching grid updates
+static void Step(Objects& o, SpatialGrid& grid) {
+    for (uint32_t i = 0; i < (uint32_t)o.x.size(); i++) {
+        o.x[i] += o.vx[i] / 60.0f;
+        o.y[i] += o.vy[i] / 60.0f;
+        if (o.x[i] < 0.0f || o.x[i] > WORLD_W - OBJECT_SIZE) o.vx[i] = -o.vx[i];
+        if (o.y[i] < 0.0f || o.y[i] > WORLD_H - OBJECT_SIZE) o.vy[i] = -o.vy[i];
+        grid.Update(i, o.x[i], o.y[i], OBJECT_SIZE, OBJECT_SIZE);
+    }
+}
+
+static bool Overlaps(const Objects& o, uint32_t i, float x, float y, float w, float h) {
+    return o.x[i] < x + w && x < o.x[i] + OBJECT_SIZE && o.y[i] < y + h && y < o.y[i] + OBJECT_SIZE;
+}
+
+template <typename Fn>
+static double TimeNs(Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    std::vector<uint32_t> objectCounts = {100, 1000, 10000, 100000};
+    int queries = 1000;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--objects" && hasValue) objectCounts = {(uint32_t)std::max(1, atoi(argv[++i]))};
+        else if (arg == "--queries" && hasValue) queries = std::max(1, atoi(argv[++i]));
+        else {
+            fprintf(stderr, "Usage: %s [--objects N] [--queries N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<float> qx, qy;
+    for (int q = 0; q < queries; q++) {
+        qx.push_back(NextRandom() * WORLD_W);
+        qy.push_back(NextRandom() * WORLD_H);
+    }
+
+    printf("%-8s %12s %12s %12s %12s %12s %12s %10s\n", "objects", "update ns/o", "point ns",
+           "point scan", "box ns", "box scan", "pairs ms", "pairs");
+
+    bool mismatch = false;
+    for (uint32_t count : objectCounts) {
+        Objects objects = MakeObjects(count);
+        SpatialGrid grid(CELL_SIZE, count);
+        for (uint32_t i = 0; i < count; i++) grid.Insert(i, objects.x[i], objects.y[i], OBJECT_SIZE, OBJECT_SIZE);
+
+        // Incremental update cost, after a few ticks so buckets have grown to fit
+        for (int tick = 0; tick < 30; tick++) Step(objects, grid);
+        const int ticks = 30;
+        double updateNs = TimeNs([&] {
+            for (int tick = 0; tick < ticks; tick++) Step(objects, grid);
+        }) / ((double)ticks * count);
+
+        // Point queries, grid then linear scan; the hit counts must agree
+        uint64_t gridHits = 0, scanHits = 0;
+        double pointNs = TimeNs([&] {
+            for (int q = 0; q < queries; q++) grid.QueryPoint(qx[q], qy[q], [&](uint32_t) { gridHits++; });
+        }) / queries;
+        double pointScanNs = TimeNs([&] {
+            for (int q = 0; q < queries; q++) {
+                for (uint32_t i = 0; i < count; i++) {
+                    scanHits += objects.x[i] <= qx[q] && qx[q] < objects.x[i] + OBJECT_SIZE &&
+                                objects.y[i] <= qy[q] && qy[q] < objects.y[i] + OBJECT_SIZE;
+                }
+            }
+        }) / queries;
+        mismatch |= gridHits != scanHits;
+
+        uint64_t gridBoxHits = 0, scanBoxHits = 0;
+        double boxNs = TimeNs([&] {
+            for (int q = 0; q < queries; q++) {
+                grid.QueryRect(qx[q], qy[q], QUERY_SIZE, QUERY_SIZE, [&](uint32_t) { gridBoxHits++; });
+            }
+        }) / queries;
+        double boxScanNs = TimeNs([&] {
+            for (int q = 0; q < queries; q++) {
+                for (uint32_t i = 0; i < count; i++) scanBoxHits += Overlaps(objects, i, qx[q], qy[q], QUERY_SIZE, QUERY_SIZE);
+            }
+        }) / queries;
+        mismatch |= gridBoxHits != scanBoxHits;
+
+        uint64_t pairs = 0;
+        double pairsMs = TimeNs([&] { grid.QueryPairs([&](uint32_t, uint32_t) { pairs++; }); }) / 1e6;
+        if (count <= 10000) {
+            uint64_t scanPairs = 0;
+            for (uint32_t a = 0; a < count; a++) {
+                for (uint32_t b = a + 1; b < count; b++) {
+                    scanPairs += Overlaps(objects, b, objects.x[a], objects.y[a], OBJECT_SIZE, OBJECT_SIZE);
+                }
+            }
+            mismatch |= pairs != scanPairs;
+        }
+
+        printf("%-8u %12.2f %12.1f %12.1f %12.1f %12.1f %12.3f %10llu\n", count, updateNs, pointNs,
+               pointScanNs, boxNs, boxScanNs, pairsMs, (unsigned long long)pairs);
+    }
+
+    if (mismatch) {
+        fprintf(stderr, "Grid and linear scan disagree\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "raylib.h"
+#include <SDL2/SDL.h>
+#include <array>
+#include <bitset>
+
+// Left stick deflections treated as discrete presses for menu navigation
+enum class StickDirection {
+    UP,
+    DOWN,
+    LEFT,
+    RIGHT,
+    COUNT
+};
+
+// Controller state built from the SDL event queue. Held buttons and axis
+// values persist between frames; pressed/released edges are accumulated
+// over every event since the previous frame, so a press and release that
+// both land inside one frame still register as a press.
+struct ControllerState {
+    static constexpr float STICK_PRESS_THRESHOLD = 0.5f; // Deflection that counts as a stick press
+
+    bool connected = false;
+    bool activity = false;    // Any button or axis event this frame
+    Uint32 lastEventTime = 0; // SDL timestamp (ms) of the newest event seen
+    Uint32 firstEventTime = 0; // SDL timestamp (ms) of this frame's oldest event, 0 = none
+
+    std::bitset<SDL_CONTROLLER_BUTTON_MAX> buttonsDown;
+    std::bitset<SDL_CONTROLLER_BUTTON_MAX> buttonsPressed;
+    std::bitset<SDL_CONTROLLER_BUTTON_MAX> buttonsReleased;
+    std::array<Sint16, SDL_CONTROLLER_AXIS_MAX> axes{};
+
+    std::bitset<(int)StickDirection::COUNT> stickDown;
+    std::bitset<(int)StickDirection::COUNT> stickPressed;
+
+    bool IsButtonDown(SDL_GameControllerButton button) const { return buttonsDown[button]; }
+    bool IsButtonPressed(SDL_GameControllerButton button) const { return buttonsPressed[button]; }
+    bool IsButtonReleased(SDL_GameControllerButton button) const { return buttonsReleased[button]; }
+    Sint16 GetAxisRaw(SDL_GameControllerAxis axis) const { return axes[axis]; }
+    float GetAxis(SDL_GameControllerAxis axis) const { return axes[axis] / 32767.0f; }
+    bool IsStickPressed(StickDirection direction) const { return stickPressed[(int)direction]; }
+
+    // Clears the per-frame edges before new events are applied
+    void BeginFrame() {
+        activity = false;
+        firstEventTime = 0;
+        buttonsPressed.reset();
+        buttonsReleased.reset();
+        stickPressed.reset();
+    }
+
+    void ApplyEvent(const SDL_Event& event) {
+        switch (event.type) {
+            case SDL_CONTROLLERBUTTONDOWN:
+            case SDL_CONTROLLERBUTTONUP: {
+                int button = event.cbutton.button;
+                if (button < 0 || button >= SDL_CONTROLLER_BUTTON_MAX) return;
+                bool down = event.cbutton.state == SDL_PRESSED;
+                if (down && !buttonsDown[button]) buttonsPressed[button] = true;
+                if (!down && buttonsDown[button]) buttonsReleased[button] = true;
+                buttonsDown[button] = down;
+                NoteEvent(event.cbutton.timestamp);
+                break;
+            }
+            case SDL_CONTROLLERAXISMOTION: {
+                int axis = event.caxis.axis;
+                if (axis < 0 || axis >= SDL_CONTROLLER_AXIS_MAX) return;
+                axes[axis] = event.caxis.value;
+                NoteEvent(event.caxis.timestamp);
+                UpdateStickDirections();
+                break;
+            }
+        }
+    }
+
+    // Drops all held state, e.g. when the device goes away
+    void Reset() { *this = ControllerState(); }
+
+private:
+    void NoteEvent(Uint32 timestamp) {
+        lastEventTime = timestamp;
+        if (firstEventTime == 0) firstEventTime = timestamp;
+        activity = true;
+    }
+
+    // Run after every axis event so a flick that returns to center within one frame still counts
+    void UpdateStickDirections() {
+        float x = GetAxis(SDL_CONTROLLER_AXIS_LEFTX);
+        float y = GetAxis(SDL_CONTROLLER_AXIS_LEFTY);
+        const bool current[(int)StickDirection::COUNT] = {
+            -y > STICK_PRESS_THRESHOLD, y > STICK_PRESS_THRESHOLD,
+            -x > STICK_PRESS_THRESHOLD, x > STICK_PRESS_THRESHOLD
+        };
+        for (int i = 0; i < (int)StickDirection::COUNT; i++) {
+            if (current[i] && !stickDown[i]) stickPressed[i] = true;
+            stickDown[i] = current[i];
+        }
+    }
+};
+
+// Snapshot of all input the game reads during one frame. Everything in Game
+// reads from this instead of querying raylib or SDL directly, so the input
+// can come from the live devices or from a script.
+struct InputState {
+    static constexpr int MAX_KEYS = 512;
+    static constexpr int MAX_MOUSE_BUTTONS = 8;
+    static constexpr int MAX_PADS = 4; // One lane per controller slot
+
+    float frameTime = 0.0f; // Seconds since the previous frame
+
+    std::bitset<MAX_KEYS> keysDown;
+    std::bitset<MAX_KEYS> keysPressed; // Went down this frame
+    bool anyKeyPressed = false;
+
+    Vector2 mousePosition = {0, 0};
+    Vector2 mouseDelta = {0, 0};
+    std::bitset<MAX_MOUSE_BUTTONS> mousePressed;
+
+    ControllerState controller;                // The pad used most recently, for menus
+    std::array<ControllerState, MAX_PADS> pads; // Every slot, by slot index, for the player lanes
+
+    bool IsKeyDown(int key) const { return key >= 0 && key < MAX_KEYS && keysDown[key]; }
+    bool IsKeyPressed(int key) const { return key >= 0 && key < MAX_KEYS && keysPressed[key]; }
+    bool IsMouseButtonPressed(int button) const { return button >= 0 && button < MAX_MOUSE_BUTTONS && mousePressed[button]; }
+    bool IsMouseMoving() const { return mouseDelta.x != 0 || mouseDelta.y != 0; }
+
+    void Clear() { *this = InputState(); }
+};
+
+// Produces one InputState per frame
+class InputSource {
+public:
+    virtual ~InputSource() = default;
+    virtual void Capture(InputState& state) = 0;
+};
@@ -0,0 +1,371 @@
+#pragma once
+
+#include "input.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+// Binary input log: every InputState the game consumed, one record per frame,
+// so a session can be fed back through InputReplaySource and produce the same
+// menu actions and simulation ticks. Frame times are recorded too; replaying
+// them in a headless, uncapped game runs the session faster than real time.
+//
+// File layout (little-endian, same conventions as save_format.h):
+//
+//   Header, 16 bytes
+//     char[4]  magic        "RTIN"
+//     uint16   version      INPUT_LOG_VERSION
+//     uint16   headerSize   16
+//     uint16   width        Window size when recording started; mouse
+//     uint16   height       positions are only meaningful at this size
+//     uint32   reserved
+//
+//   Frames, each a flags byte followed by the parts that changed since the
+//   previous frame, in flag order:
+//     FRAME_TIME   float    seconds
+//     KEYS         uint8 n, n x uint16 key (bit 15 set = now down); then
+//                  uint8 m, m x uint16 key pressed this frame
+//     ANY_KEY      (no payload) anyKeyPressed is true
+//     MOUSE_POS    float x, float y
+//     MOUSE_DELTA  float x, float y; absent means no movement
+//     MOUSE_BUTTON uint8 pressed bits; absent means none pressed
+//     CONTROLLER   the whole ControllerState, see WriteController()
+//     PADS         uint8 mask of the pad slots that changed, then one
+//                  controller record per set bit, lowest slot first
+//
+// A frame with no input and an unchanged frame time takes one byte.
+// Version 1 logs (no PADS) still replay: their one controller stands in as
+// pad 0, which is what a single player's lane reads.
+namespace input_log {
+
+constexpr char MAGIC[4] = {'R', 'T', 'I', 'N'};
+constexpr uint16_t VERSION = 2;
+constexpr uint16_t OLDEST_VERSION = 1; // Oldest version the replay still reads
+constexpr uint16_t HEADER_SIZE = 16;
+
+enum FrameFlag : uint8_t {
+    FRAME_TIME = 1 << 0,
+    KEYS = 1 << 1,
+    ANY_KEY = 1 << 2,
+    MOUSE_POS = 1 << 3,
+    MOUSE_DELTA = 1 << 4,
+    MOUSE_BUTTON = 1 << 5,
+    CONTROLLER = 1 << 6,
+    PADS = 1 << 7,
+};
+
+inline bool SameController(const ControllerState& a, const ControllerState& b) {
+    return a.connected == b.connected && a.activity == b.activity && a.lastEventTime == b.lastEventTime &&
+           a.buttonsDown == b.buttonsDown && a.buttonsPressed == b.buttonsPressed &&
+           a.buttonsReleased == b.buttonsReleased && a.axes == b.axes && a.stickDown == b.stickDown &&
+           a.stickPressed == b.stickPressed;
+}
+
+} // namespace input_log
+
+// Passes frames through from another source and appends each one to a log.
+// Writes go through a large stdio buffer, so a frame costs a few bytes of
+// memcpy and the disk sees one write per BUFFER_SIZE bytes.
+class InputRecorder : public InputSource {
+public:
+    static constexpr size_t BUFFER_SIZE = 64 * 1024;
+
+    explicit InputRecorder(InputSource* source) : source(source) {}
+    ~InputRecorder() { Close(); }
+
+    bool Open(const std::string& path, int width, int height) {
+        Close();
+        file = fopen(path.c_str(), "wb");
+        if (!file) return false;
+        setvbuf(file, nullptr, _IOFBF, BUFFER_SIZE);
+        uint8_t header[input_log::HEADER_SIZE] = {};
+        memcpy(header, input_log::MAGIC, 4);
+        PutU16(header + 4, input_log::VERSION);
+        PutU16(header + 6, input_log::HEADER_SIZE);
+        PutU16(header + 8, (uint16_t)width);
+        PutU16(header + 10, (uint16_t)height);
+        fwrite(header, 1, sizeof(header), file);
+        previous = InputState();
+        return true;
+    }
+
+    // Flushes and closes the log
+    void Close() {
+        if (!file) return;
+        fclose(file);
+        file = nullptr;
+    }
+
+    uint64_t GetRecordedFrames() const { return frames; }
+
+    void Capture(InputState& state) override {
+        source->Capture(state);
+        if (file) WriteFrame(state);
+    }
+
+private:
+    void WriteFrame(const InputState& state) {
+        using namespace input_log;
+        uint8_t flags = 0;
+        if (state.frameTime != previous.frameTime) flags |= FRAME_TIME;
+        if (state.keysDown != previous.keysDown || state.keysPressed.any()) flags |= KEYS;
+        if (state.anyKeyPressed) flags |= ANY_KEY;
+        if (state.mousePosition.x != previous.mousePosition.x || state.mousePosition.y != previous.mousePosition.y) flags |= MOUSE_POS;
+        if (state.mouseDelta.x != 0 || state.mouseDelta.y != 0) flags |= MOUSE_DELTA;
+        if (state.mousePressed.any()) flags |= MOUSE_BUTTON;
+        if (!SameController(state.controller, previous.controller)) flags |= CONTROLLER;
+        uint8_t changedPads = 0;
+        for (int i = 0; i < InputState::MAX_PADS; i++) {
+            if (!SameController(state.pads[i], previous.pads[i])) changedPads |= (uint8_t)(1 << i);
+        }
+        if (changedPads) flags |= PADS;
+        fputc(flags, file);
+
+        if (flags & FRAME_TIME) WriteF32(state.frameTime);
+        if (flags & KEYS) {
+            std::bitset<InputState::MAX_KEYS> toggled = state.keysDown ^ previous.keysDown;
+            WriteKeyList(toggled, &state.keysDown);
+            WriteKeyList(state.keysPressed, nullptr);
+        }
+        if (flags & MOUSE_POS) {
+            WriteF32(state.mousePosition.x);
+            WriteF32(state.mousePosition.y);
+        }
+        if (flags & MOUSE_DELTA) {
+            WriteF32(state.mouseDelta.x);
+            WriteF32(state.mouseDelta.y);
+        }
+        if (flags & MOUSE_BUTTON) fputc((int)state.mousePressed.to_ulong(), file);
+        if (flags & CONTROLLER) WriteController(state.controller);
+        if (flags & PADS) {
+            fputc(changedPads, file);
+            for (int i = 0; i < InputState::MAX_PADS; i++) {
+                if (changedPads & (1 << i)) WriteController(state.pads[i]);
+            }
+        }
+
+        previous = state;
+        frames++;
+    }
+
+    // Keys set in bits; with down, bit 15 carries that key's new down state
+    void WriteKeyList(const std::bitset<InputState::MAX_KEYS>& bits, const std::bitset<InputState::MAX_KEYS>* down) {
+        size_t count = std::min<size_t>(bits.count(), 255); // Far more keys than a keyboard can hold at once
+        fputc((int)count, file);
+        for (int key = 0; key < InputState::MAX_KEYS && count > 0; key++) {
+            if (!bits[key]) continue;
+            WriteU16((uint16_t)key | (down && (*down)[key] ? 0x8000 : 0));
+            count--;
+        }
+    }
+
+    void WriteController(const ControllerState& pad) {
+        fputc((pad.connected ? 1 : 0) | (pad.activity ? 2 : 0), file);
+        WriteU32(pad.lastEventTime);
+        WriteU32((uint32_t)pad.buttonsDown.to_ulong());
+        WriteU32((uint32_t)pad.buttonsPressed.to_ulong());
+        WriteU32((uint32_t)pad.buttonsReleased.to_ulong());
+        for (Sint16 axis : pad.axes) WriteU16((uint16_t)axis);
+        fputc((int)(pad.stickDown.to_ulong() | (pad.stickPressed.to_ulong() << 4)), file);
+    }
+
+    static void PutU16(uint8_t* p, uint16_t v) {
+        p[0] = v & 0xFF;
+        p[1] = v >> 8;
+    }
+
+    void WriteU16(uint16_t v) {
+        uint8_t bytes[2];
+        PutU16(bytes, v);
+        fwrite(bytes, 1, 2, file);
+    }
+
+    void WriteU32(uint32_t v) {
+        uint8_t bytes[4];
+        for (int i = 0; i < 4; i++) bytes[i] = (v >> (8 * i)) & 0xFF;
+        fwrite(bytes, 1, 4, file);
+    }
+
+    void WriteF32(float v) {
+        uint32_t bits;
+        memcpy(&bits, &v, sizeof(bits));
+        WriteU32(bits);
+    }
+
+    InputSource* source;
+    FILE* file = nullptr;
+    InputState previous; // Last frame written; the next one is encoded against it
+    uint64_t frames = 0;
+};
+
+// Feeds a recorded log back in place of the live devices. Once the log runs
+// out it keeps returning idle frames at the last frame time and IsFinished()
+// turns true.
+class InputReplaySource : public InputSource {
+public:
+    ~InputReplaySource() { Close(); }
+
+    // False if the file is missing or not an input log of a version this reads
+    bool Open(const std::string& path) {
+        Close();
+        file = fopen(path.c_str(), "rb");
+        if (!file) return false;
+        setvbuf(file, nullptr, _IOFBF, 64 * 1024);
+        uint8_t header[input_log::HEADER_SIZE];
+        if (fread(header, 1, sizeof(header), file) != sizeof(header) || memcmp(header, input_log::MAGIC, 4) != 0 ||
+            GetU16(header + 4) < input_log::OLDEST_VERSION || GetU16(header + 4) > input_log::VERSION ||
+            GetU16(header + 6) < input_log::HEADER_SIZE) {
+            Close();
+            return false;
+        }
+        version = GetU16(header + 4);
+        fseek(file, GetU16(header + 6), SEEK_SET);
+        width = GetU16(header + 8);
+        height = GetU16(header + 10);
+        current = InputState();
+        finished = false;
+        frames = 0;
+        return true;
+    }
+
+    void Close() {
+        if (!file) return;
+        fclose(file);
+        file = nullptr;
+    }
+
+    // Window size the log was recorded at
+    int GetWidth() const { return width; }
+    int GetHeight() const { return height; }
+
+    bool IsFinished() const { return finished; }
+    uint64_t GetReplayedFrames() const { return frames; }
+
+    void Capture(InputState& state) override {
+        if (!finished && !ReadFrame()) {
+            finished = true;
+            Close();
+        }
+        if (finished) {
+            // Nothing held, nothing pressed; time keeps moving so the game can wind down
+            float frameTime = current.frameTime;
+            current.Clear();
+            current.frameTime = frameTime;
+        }
+        state = current;
+    }
+
+private:
+    bool ReadFrame() {
+        using namespace input_log;
+        int flags = fgetc(file);
+        if (flags == EOF) return false;
+
+        // Held state carries over; edges and motion only exist on the frame that logged them
+        InputState next;
+        next.frameTime = current.frameTime;
+        next.keysDown = current.keysDown;
+        next.mousePosition = current.mousePosition;
+        next.controller = current.controller;
+        next.pads = current.pads;
+
+        bool ok = true;
+        if (flags & FRAME_TIME) ok &= ReadF32(next.frameTime);
+        if (flags & KEYS) {
+            uint16_t key = 0;
+            int toggles = fgetc(file);
+            for (int i = 0; ok && i < toggles; i++) {
+                if (!ReadU16(key)) {
+                    ok = false;
+                    break;
+                }
+                if ((key & 0x7FFF) < InputState::MAX_KEYS) next.keysDown[key & 0x7FFF] = (key & 0x8000) != 0;
+            }
+            int pressed = fgetc(file);
+            for (int i = 0; ok && i < pressed; i++) {
+                if (!ReadU16(key)) {
+                    ok = false;
+                    break;
+                }
+                if (key < InputState::MAX_KEYS) next.keysPressed[key] = true;
+            }
+            ok &= toggles != EOF && pressed != EOF;
+        }
+        next.anyKeyPressed = (flags & ANY_KEY) != 0;
+        if (flags & MOUSE_POS) ok &= ReadF32(next.mousePosition.x) && ReadF32(next.mousePosition.y);
+        if (flags & MOUSE_DELTA) ok &= ReadF32(next.mouseDelta.x) && ReadF32(next.mouseDelta.y);
+        if (flags & MOUSE_BUTTON) {
+            int buttons = fgetc(file);
+            ok &= buttons != EOF;
+            next.mousePressed = std::bitset<InputState::MAX_MOUSE_BUTTONS>((unsigned long)(buttons & 0xFF));
+        }
+        if (flags & CONTROLLER) ok &= ReadController(next.controller);
+        if (flags & PADS) {
+            int changed = fgetc(file);
+            ok &= changed != EOF;
+            for (int i = 0; ok && i < InputState::MAX_PADS; i++) {
+                if (changed & (1 << i)) ok &= ReadController(next.pads[i]);
+            }
+        }
+        if (version < 2) next.pads[0] = next.controller;
+        if (!ok) return false; // Truncated: the recording stopped mid-frame
+
+        current = next;
+        frames++;
+        return true;
+    }
+
+    bool ReadController(ControllerState& pad) {
+        int bits = fgetc(file);
+        uint32_t down = 0, pressed = 0, released = 0;
+        bool ok = bits != EOF && ReadU32(pad.lastEventTime) && ReadU32(down) && ReadU32(pressed) && ReadU32(released);
+        for (Sint16& axis : pad.axes) {
+            uint16_t value = 0;
+            ok = ok && ReadU16(value);
+            axis = (Sint16)value;
+        }
+        int sticks = fgetc(file);
+        if (!ok || sticks == EOF) return false;
+        pad.connected = (bits & 1) != 0;
+        pad.activity = (bits & 2) != 0;
+        pad.buttonsDown = std::bitset<SDL_CONTROLLER_BUTTON_MAX>(down);
+        pad.buttonsPressed = std::bitset<SDL_CONTROLLER_BUTTON_MAX>(pressed);
+        pad.buttonsReleased = std::bitset<SDL_CONTROLLER_BUTTON_MAX>(released);
+        pad.stickDown = std::bitset<(int)StickDirection::COUNT>((unsigned long)(sticks & 0x0F));
+        pad.stickPressed = std::bitset<(int)StickDirection::COUNT>((unsigned long)((sticks >> 4) & 0x0F));
+        return true;
+    }
+
+    static uint16_t GetU16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+
+    bool ReadU16(uint16_t& v) {
+        uint8_t bytes[2];
+        if (fread(bytes, 1, 2, file) != 2) return false;
+        v = GetU16(bytes);
+        return true;
+    }
+
+    bool ReadU32(uint32_t& v) {
+        uint8_t bytes[4];
+        if (fread(bytes, 1, 4, file) != 4) return false;
+        v = (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+        return true;
+    }
+
+    bool ReadF32(float& v) {
+        uint32_t bits;
+        if (!ReadU32(bits)) return false;
+        memcpy(&v, &bits, sizeof(v));
+        return true;
+    }
+
+    FILE* file = nullptr;
+    InputState current; // Last frame read; held state carries into the next
+    uint16_t version = 0;
+    int width = 0;
+    int height = 0;
+    bool finished = false;
+    uint64_t frames = 0;
+};
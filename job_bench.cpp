@@ -0,0 +1,191 @@
+// Micro-benchmark for the job system (job_system.h): times ParallelFor() and
+// pipelines of jobs that each depend on the stage before, checks every stage
+// saw the previous one finished, and checks a dependency released into a full
+// deque runs inline without deadlocking.
+//
+// Usage: job_bench [--threads N] [--jobs N] [--stages N] [--rounds N]
+//
+// Needs neither raylib nor a display.
+
+#include "job_system.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const uint32_t ITEMS_PER_JOB = 256;
+
+// One pipeline stage: bumps every value from stage to stage + 1
+struct Stage {
+    int* values = nullptr;
+    int stage = 0;
+    std::atomic<bool>* outOfOrder = nullptr;
+};
+
+static void RunStage(void* context, uint32_t begin, uint32_t end) {
+    Stage& s = *static_cast<Stage*>(context);
+    for (uint32_t i = begin; i < end; i++) {
+        if (s.values[i] != s.stage) s.outOfOrder->store(true, std::memory_order_relaxed);
+        s.values[i] = s.stage + 1;
+    }
+}
+
+// Schedules every stage up front, each job depending on the whole previous
+// stage, and waits for the last one
+static void RunPipeline(JobSystem& jobs, std::vector<Stage>& stages, JobCounter* counters, uint32_t jobsPerStage) {
+    for (size_t s = 0; s < stages.size(); s++) {
+        Job job;
+        job.fn = RunStage;
+        job.context = &stages[s];
+        job.counter = &counters[s];
+        job.dependency = s > 0 ? &counters[s - 1] : nullptr;
+        for (uint32_t j = 0; j < jobsPerStage; j++) {
+            job.begin = j * ITEMS_PER_JOB;
+            job.end = job.begin + ITEMS_PER_JOB;
+            jobs.Schedule(job);
+        }
+    }
+    jobs.Wait(counters[stages.size() - 1]);
+}
+
+// Holds the only worker in a job and fills the calling thread's deque, then
+// schedules a job that parks a chain of jobs on its own counter. Finishing it
+// releases the chain into the full deque, so each link runs inline on this
+// thread, inside the previous one's release. Returns false if the chain did
+// not run there and then, or ran out of order.
+static bool CheckFullDequeRelease() {
+    JobSystem jobs;
+    jobs.Start(1);
+
+    std::atomic<bool> blockerStarted{false}, releaseBlocker{false};
+    struct Blocker {
+        std::atomic<bool>* started;
+        std::atomic<bool>* release;
+    } blocker = {&blockerStarted, &releaseBlocker};
+    JobCounter blockerDone;
+    Job block;
+    block.fn = [](void* context, uint32_t, uint32_t) {
+        Blocker& b = *static_cast<Blocker*>(context);
+        b.started->store(true);
+        while (!b.release->load()) std::this_thread::yield();
+    };
+    block.context = &blocker;
+    block.counter = &blockerDone;
+    jobs.Schedule(block);
+    while (!blockerStarted.load()) std::this_thread::yield(); // The worker stole it
+
+    JobCounter fillerDone;
+    Job filler;
+    filler.fn = [](void*, uint32_t, uint32_t) {};
+    filler.counter = &fillerDone;
+    for (int i = 0; i < JobSystem::QUEUE_CAPACITY; i++) jobs.Schedule(filler);
+
+    static const int CHAIN = 4;
+    struct Chain {
+        JobSystem* jobs;
+        std::vector<int> values = std::vector<int>(ITEMS_PER_JOB, 0);
+        std::atomic<bool> outOfOrder{false};
+        Stage stages[CHAIN];
+        JobCounter counters[CHAIN];
+    } chain;
+    chain.jobs = &jobs;
+    for (int s = 0; s < CHAIN; s++) chain.stages[s] = {chain.values.data(), s, &chain.outOfOrder};
+
+    Job first;
+    first.fn = [](void* context, uint32_t begin, uint32_t end) {
+        Chain& c = *static_cast<Chain*>(context);
+        RunStage(&c.stages[0], begin, end);
+        for (int s = 1; s < CHAIN; s++) { // Each counter is pending by now, so these park
+            Job job;
+            job.fn = RunStage;
+            job.context = &c.stages[s];
+            job.end = ITEMS_PER_JOB;
+            job.counter = &c.counters[s];
+            job.dependency = &c.counters[s - 1];
+            c.jobs->Schedule(job);
+        }
+    };
+    first.context = &chain;
+    first.end = ITEMS_PER_JOB;
+    first.counter = &chain.counters[0];
+    jobs.Schedule(first); // Deque full: runs here
+    bool ranInline = chain.counters[CHAIN - 1].IsDone();
+
+    releaseBlocker.store(true);
+    jobs.Wait(chain.counters[CHAIN - 1]);
+    jobs.Wait(fillerDone);
+    jobs.Wait(blockerDone);
+    jobs.Stop();
+    return ranInline && !chain.outOfOrder.load() && chain.values[0] == CHAIN;
+}
+
+int main(int argc, char** argv) {
+    int threads = 0; // 0 = one worker per extra core
+    std::vector<uint32_t> jobCounts = {16, 128, 1024};
+    int stageCount = 4;
+    int rounds = 200;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--threads" && hasValue) threads = atoi(argv[++i]);
+        else if (arg == "--jobs" && hasValue) jobCounts = {(uint32_t)std::max(1, atoi(argv[++i]))};
+        else if (arg == "--stages" && hasValue) stageCount = std::max(1, atoi(argv[++i]));
+        else if (arg == "--rounds" && hasValue) rounds = std::max(1, atoi(argv[++i]));
+        else {
+            fprintf(stderr, "Usage: %s [--threads N] [--jobs N] [--stages N] [--rounds N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    bool ok = CheckFullDequeRelease();
+    printf("Full deque release: %s\n", ok ? "ok" : "FAILED");
+
+    JobSystem jobs;
+    jobs.Start(threads);
+    printf("Worker threads: %d\n\n", jobs.GetWorkerCount());
+    printf("%-8s %-12s %12s %12s\n", "jobs", "mode", "ns/job", "ns/item");
+
+    for (uint32_t jobCount : jobCounts) {
+        uint32_t items = jobCount * ITEMS_PER_JOB;
+        std::vector<int> values(items);
+        std::atomic<bool> outOfOrder{false};
+
+        // The same number of items and stages, once as back-to-back ParallelFor() calls...
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; r++) {
+            std::fill(values.begin(), values.end(), 0);
+            for (int s = 0; s < stageCount; s++) {
+                Stage stage = {values.data(), s, &outOfOrder};
+                jobs.ParallelFor(items, ITEMS_PER_JOB, [&stage](uint32_t begin, uint32_t end) { RunStage(&stage, begin, end); });
+            }
+        }
+        double parallelNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        // ...and once as a pipeline scheduled up front, ordered by dependencies alone
+        std::vector<Stage> stages(stageCount);
+        std::vector<JobCounter> counters(stageCount);
+        for (int s = 0; s < stageCount; s++) stages[s] = {values.data(), s, &outOfOrder};
+        start = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; r++) {
+            std::fill(values.begin(), values.end(), 0);
+            RunPipeline(jobs, stages, counters.data(), jobCount);
+        }
+        double pipelineNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        bool finished = std::all_of(values.begin(), values.end(), [&](int v) { return v == stageCount; });
+        if (outOfOrder.load() || !finished) {
+            printf("%-8u stages ran out of order\n", jobCount);
+            ok = false;
+        }
+        double totalJobs = (double)rounds * stageCount * jobCount;
+        printf("%-8u %-12s %12.1f %12.3f\n", jobCount, "parallel_for", parallelNs / totalJobs, parallelNs / (totalJobs * ITEMS_PER_JOB));
+        printf("%-8u %-12s %12.1f %12.3f\n", jobCount, "pipeline", pipelineNs / totalJobs, pipelineNs / (totalJobs * ITEMS_PER_JOB));
+    }
+    jobs.Stop();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,271 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Counts outstanding jobs. Pass one to JobSystem::Schedule() for every job it
+// should track, then JobSystem::Wait() on it, or name it as another job's
+// dependency so that job only starts once everything counted here finished.
+class JobCounter {
+public:
+    bool IsDone() const { return pending.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+    std::atomic<int> pending{0};
+};
+
+// A range of work: fn(context, begin, end)
+struct Job {
+    void (*fn)(void* context, uint32_t begin, uint32_t end) = nullptr;
+    void* context = nullptr;
+    uint32_t begin = 0;
+    uint32_t end = 0;
+    JobCounter* counter = nullptr;          // Decremented when the job finishes; may be null
+    const JobCounter* dependency = nullptr; // Job is held back until this is done; may be null
+};
+
+// Small work-stealing scheduler for CPU-only work (entity updates, batch
+// building). Jobs must not touch raylib, GL or SDL; those stay on the thread
+// that calls Start(), which owns queue 0 and helps run jobs while it waits.
+//
+// Every thread has its own fixed-size deque. The owner pushes and pops at the
+// back, so it works through its own jobs newest first while they are still
+// in cache; idle workers steal the oldest job from the front of someone
+// else's deque. Threads with nothing to run or steal sleep until a job is
+// queued. Scheduling never allocates: a full deque runs the job inline
+// instead.
+//
+// Jobs with an unfinished dependency wait in a side list and are queued by
+// whichever thread finishes the last job of that dependency.
+class JobSystem {
+public:
+    static constexpr int MAX_WORKERS = 31;
+    static constexpr int QUEUE_CAPACITY = 512;     // Jobs per thread's deque
+    static constexpr int MAX_DEFERRED_JOBS = 256;  // Jobs waiting on a dependency
+
+    ~JobSystem() { Stop(); }
+
+    // workerThreads 0 = one per core besides the calling thread
+    void Start(int workerThreads) {
+        if (running) return;
+        if (workerThreads <= 0) workerThreads = (int)std::thread::hardware_concurrency() - 1;
+        workerThreads = std::clamp(workerThreads, 0, MAX_WORKERS);
+
+        queues.clear();
+        for (int i = 0; i <= workerThreads; i++) queues.push_back(std::make_unique<WorkQueue>());
+        deferred.reserve(MAX_DEFERRED_JOBS);
+        stopRequested = false;
+        running = true;
+        threadIndex = 0;
+        for (int i = 1; i <= workerThreads; i++) {
+            workers.emplace_back(&JobSystem::WorkerMain, this, i);
+        }
+    }
+
+    // Runs whatever is still queued, then joins the workers
+    void Stop() {
+        if (!running) return;
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopRequested = true;
+        }
+        wake.notify_all();
+        for (std::thread& worker : workers) worker.join();
+        workers.clear();
+        while (RunOneJob(0)) {}
+        running = false;
+    }
+
+    int GetWorkerCount() const { return (int)workers.size(); }
+
+    // Queues job on the calling thread's deque, or parks it until its dependency is done
+    void Schedule(Job job) {
+        if (job.counter) job.counter->pending.fetch_add(1, std::memory_order_relaxed);
+        if (!running) {
+            if (job.dependency) Wait(*job.dependency);
+            Execute(job);
+            return;
+        }
+        if (job.dependency && !job.dependency->IsDone()) {
+            std::unique_lock<std::mutex> lock(deferredMutex);
+            // Re-check under the lock: ReleaseDeferred() scans the list while holding it
+            if (!job.dependency->IsDone()) {
+                if (deferred.size() < MAX_DEFERRED_JOBS) {
+                    deferred.push_back(job);
+                    return;
+                }
+                lock.unlock();
+                Wait(*job.dependency);
+            }
+        }
+        Enqueue(job);
+    }
+
+    // Returns once counter reaches zero, running queued jobs in the meantime
+    void Wait(const JobCounter& counter) {
+        int self = std::min(threadIndex, (int)queues.size() - 1);
+        while (!counter.IsDone()) {
+            if (!running || !RunOneJob(self)) std::this_thread::yield();
+        }
+    }
+
+    // Calls fn(begin, end) over [0, count) in chunks of at least minBatch,
+    // spread across the workers, and returns when all of them are done. The
+    // calling thread runs the first chunk itself; counts of minBatch or less
+    // run inline without touching the queues.
+    template <typename Fn>
+    void ParallelFor(uint32_t count, uint32_t minBatch, Fn&& fn) {
+        if (count == 0) return;
+        uint32_t chunks = (uint32_t)(GetWorkerCount() + 1) * 4; // A few per thread, so stealing can even out the load
+        uint32_t batch = std::max(std::max(minBatch, 1u), (count + chunks - 1) / chunks);
+        if (!running || workers.empty() || batch >= count) {
+            fn(0u, count);
+            return;
+        }
+
+        using F = std::remove_reference_t<Fn>;
+        JobCounter counter;
+        Job job;
+        job.fn = [](void* context, uint32_t begin, uint32_t end) { (*static_cast<F*>(context))(begin, end); };
+        job.context = const_cast<void*>(static_cast<const void*>(&fn));
+        job.counter = &counter;
+        for (uint32_t begin = batch; begin < count; begin += batch) {
+            job.begin = begin;
+            job.end = std::min(count, begin + batch);
+            Schedule(job);
+        }
+        fn(0u, batch);
+        Wait(counter);
+    }
+
+private:
+    // Mutex-guarded ring buffer; owner uses the back, thieves the front
+    struct WorkQueue {
+        std::mutex mutex;
+        std::array<Job, QUEUE_CAPACITY> jobs;
+        uint32_t head = 0; // Oldest job
+        uint32_t size = 0;
+
+        bool PushBack(const Job& job) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (size == QUEUE_CAPACITY) return false;
+            jobs[(head + size) % QUEUE_CAPACITY] = job;
+            size++;
+            return true;
+        }
+
+        bool PopBack(Job& job) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (size == 0) return false;
+            size--;
+            job = jobs[(head + size) % QUEUE_CAPACITY];
+            return true;
+        }
+
+        bool StealFront(Job& job) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (size == 0) return false;
+            job = jobs[head];
+            head = (head + 1) % QUEUE_CAPACITY;
+            size--;
+            return true;
+        }
+    };
+
+    void Enqueue(const Job& job) {
+        int self = std::min(threadIndex, (int)queues.size() - 1);
+        if (!queues[self]->PushBack(job)) {
+            Execute(job); // Deque full: run it here rather than grow
+            return;
+        }
+        // Sequentially consistent, paired with WorkerMain(): either this sees the
+        // sleeper or the sleeper sees the job
+        queuedJobs.fetch_add(1);
+        if (sleepingWorkers.load() > 0) {
+            // Taking the lock orders this with a worker that is about to sleep
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            wake.notify_one();
+        }
+    }
+
+    // Own deque first, then steal round-robin from the others
+    bool RunOneJob(int self) {
+        Job job;
+        bool found = queues[self]->PopBack(job);
+        for (int i = 1; !found && i < (int)queues.size(); i++) {
+            found = queues[(self + i) % queues.size()]->StealFront(job);
+        }
+        if (!found) return false;
+        queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+        Execute(job);
+        return true;
+    }
+
+    void Execute(const Job& job) {
+        job.fn(job.context, job.begin, job.end);
+        if (job.counter && job.counter->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            ReleaseDeferred();
+        }
+    }
+
+    // A counter just reached zero: queue every parked job whose dependency is now done.
+    // Jobs are taken off the list a few at a time and queued after unlocking, since
+    // Enqueue() may run one inline and that job's counter can release more.
+    void ReleaseDeferred() {
+        std::array<Job, 32> ready;
+        size_t count;
+        do {
+            count = 0;
+            {
+                std::lock_guard<std::mutex> lock(deferredMutex);
+                for (size_t i = 0; i < deferred.size() && count < ready.size();) {
+                    if (deferred[i].dependency->IsDone()) {
+                        ready[count++] = deferred[i];
+                        deferred[i] = deferred.back();
+                        deferred.pop_back();
+                    } else {
+                        i++;
+                    }
+                }
+            }
+            for (size_t i = 0; i < count; i++) Enqueue(ready[i]);
+        } while (count == ready.size());
+    }
+
+    void WorkerMain(int index) {
+        threadIndex = index;
+        while (true) {
+            if (RunOneJob(index)) continue;
+
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleepingWorkers.fetch_add(1);
+            wake.wait(lock, [this] { return stopRequested || queuedJobs.load() > 0; });
+            sleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+            if (stopRequested) break;
+        }
+    }
+
+    static inline thread_local int threadIndex = 0; // Queue owned by the current thread; 0 for non-workers
+
+    std::vector<std::unique_ptr<WorkQueue>> queues; // [0] = the thread that called Start()
+    std::vector<std::thread> workers;
+    bool running = false;
+
+    std::mutex deferredMutex;
+    std::vector<Job> deferred; // Guarded by deferredMutex; capacity fixed at Start()
+
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    bool stopRequested = false; // Guarded by sleepMutex
+    std::atomic<int> queuedJobs{0};
+    std::atomic<int> sleepingWorkers{0};
+};
@@ -0,0 +1,113 @@
+// Micro-benchmark for the entity movement kernels (move_kernels.h): runs every
+// kernel this CPU supports over the same entities, checks each against the
+// scalar result and prints time per entity update and speedup over scalar.
+//
+// Usage: kernel_bench [--entities N] [--iterations N]
+//
+// Needs neither raylib nor a display.
+
+#include "move_kernels.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+struct Arrays {
+    std::vector<float> px, py, vx, vy, sz;
+};
+
+static Arrays MakeEntities(uint32_t count) {
+    Arrays a;
+    a.px.resize(count);
+    a.py.resize(count);
+    a.vx.resize(count);
+    a.vy.resize(count);
+    a.sz.resize(count);
+    uint32_t seed = 0x9E3779B9u;
+    auto nextRandom = [&seed]() {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return (seed & 0xFFFFFF) / (float)0xFFFFFF;
+    };
+    for (uint32_t i = 0; i < count; i++) {
+        a.sz[i] = 4.0f + nextRandom() * 28.0f;
+        a.px[i] = nextRandom() * (1280.0f - a.sz[i]);
+        a.py[i] = nextRandom() * (720.0f - a.sz[i]);
+        a.vx[i] = (nextRandom() * 2.0f - 1.0f) * 400.0f;
+        a.vy[i] = (nextRandom() * 2.0f - 1.0f) * 400.0f;
+    }
+    return a;
+}
+
+static void Run(const move_kernels::MoveKernel& kernel, Arrays& a, int steps) {
+    for (int step = 0; step < steps; step++) {
+        kernel.fn(a.px.data(), a.py.data(), a.vx.data(), a.vy.data(), a.sz.data(),
+                  (uint32_t)a.px.size(), 1.0f / 60.0f, 1280.0f, 720.0f);
+    }
+}
+
+// Largest difference from the scalar result over every component
+static float MaxDifference(const Arrays& a, const Arrays& b) {
+    float diff = 0.0f;
+    const std::vector<float>* lhs[] = {&a.px, &a.py, &a.vx, &a.vy};
+    const std::vector<float>* rhs[] = {&b.px, &b.py, &b.vx, &b.vy};
+    for (int c = 0; c < 4; c++) {
+        for (size_t i = 0; i < lhs[c]->size(); i++) {
+            diff = std::max(diff, std::fabs((*lhs[c])[i] - (*rhs[c])[i]));
+        }
+    }
+    return diff;
+}
+
+int main(int argc, char** argv) {
+    std::vector<uint32_t> entityCounts = {1000, 10000, 100000, 1000000};
+    int iterations = 0; // 0 = scale so every size does about the same total work
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--entities" && hasValue) entityCounts = {(uint32_t)std::max(1, atoi(argv[++i]))};
+        else if (arg == "--iterations" && hasValue) iterations = std::max(1, atoi(argv[++i]));
+        else {
+            fprintf(stderr, "Usage: %s [--entities N] [--iterations N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    move_kernels::MoveKernel kernels[4];
+    int kernelCount = move_kernels::GetAvailableKernels(kernels, 4);
+    const move_kernels::MoveKernel& scalar = kernels[kernelCount - 1];
+    printf("Selected kernel: %s\n\n", move_kernels::GetMoveKernel().name);
+    printf("%-10s %-8s %12s %10s %12s\n", "entities", "kernel", "ns/entity", "speedup", "max diff");
+
+    for (uint32_t count : entityCounts) {
+        int steps = iterations > 0 ? iterations : (int)std::max<uint32_t>(10, 200000000u / count / 10);
+        const Arrays initial = MakeEntities(count);
+
+        // Reference result for the correctness check
+        Arrays reference = initial;
+        Run(scalar, reference, 16);
+
+        double scalarNs = 0.0;
+        for (int k = kernelCount - 1; k >= 0; k--) {
+            Arrays check = initial;
+            Run(kernels[k], check, 16);
+            float diff = MaxDifference(check, reference);
+
+            Arrays work = initial;
+            Run(kernels[k], work, 2); // Warm caches
+            auto start = std::chrono::steady_clock::now();
+            Run(kernels[k], work, steps);
+            double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            double nsPerEntity = elapsed / ((double)steps * count);
+            if (k == kernelCount - 1) scalarNs = nsPerEntity;
+
+            printf("%-10u %-8s %12.3f %9.2fx %12.3g\n", count, kernels[k].name, nsPerEntity,
+                   scalarNs / nsPerEntity, diff);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "controllers.h"
+#include "input.h"
+
+// Reads the real keyboard and mouse through raylib, and controllers through
+// the ControllerManager's once-per-frame pass over the SDL event queue
+class LiveInputSource : public InputSource {
+public:
+    void SetControllerManager(ControllerManager* manager) { controllers = manager; }
+
+    void Capture(InputState& state) override {
+        state.Clear();
+        state.frameTime = GetFrameTime();
+
+        for (int key : trackedKeys) {
+            state.keysDown[key] = IsKeyDown(key);
+            state.keysPressed[key] = IsKeyPressed(key) || latched.keysPressed[key];
+        }
+        state.anyKeyPressed = GetKeyPressed() != 0 || latched.anyKeyPressed;
+
+        state.mousePosition = GetMousePosition();
+        state.mouseDelta = GetMouseDelta();
+        state.mouseDelta.x += latched.mouseDelta.x;
+        state.mouseDelta.y += latched.mouseDelta.y;
+        state.mousePressed[MOUSE_LEFT_BUTTON] = IsMouseButtonPressed(MOUSE_LEFT_BUTTON);
+        state.mousePressed[MOUSE_RIGHT_BUTTON] = IsMouseButtonPressed(MOUSE_RIGHT_BUTTON);
+        state.mousePressed |= latched.mousePressed;
+        latched.Clear();
+
+        if (controllers) {
+            controllers->ProcessEvents();
+            state.controller = controllers->GetActiveState();
+            for (int i = 0; i < InputState::MAX_PADS; i++) state.pads[i] = controllers->GetSlot(i).state;
+        }
+    }
+
+    // Polls raylib again right before Capture(), for low-latency pacing.
+    // Pressed edges and mouse motion only last until the next poll, so the
+    // ones EndDrawing()'s poll delivered are kept for the coming Capture().
+    void PollLate() {
+        for (int key : trackedKeys) {
+            if (IsKeyPressed(key)) latched.keysPressed[key] = true;
+        }
+        if (GetKeyPressed() != 0) latched.anyKeyPressed = true;
+        Vector2 delta = GetMouseDelta();
+        latched.mouseDelta.x += delta.x;
+        latched.mouseDelta.y += delta.y;
+        if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) latched.mousePressed[MOUSE_LEFT_BUTTON] = true;
+        if (IsMouseButtonPressed(MOUSE_RIGHT_BUTTON)) latched.mousePressed[MOUSE_RIGHT_BUTTON] = true;
+        PollInputEvents();
+    }
+
+private:
+    static_assert(ControllerManager::MAX_CONTROLLERS == InputState::MAX_PADS, "one input lane per controller slot");
+
+    // Only the keys the game actually uses are polled
+    static constexpr int trackedKeys[] = {
+        KEY_W, KEY_A, KEY_S, KEY_D, KEY_M,
+        KEY_UP, KEY_DOWN, KEY_LEFT, KEY_RIGHT,
+        KEY_ENTER, KEY_SPACE, KEY_ESCAPE,
+        KEY_F1, KEY_F2
+    };
+
+    ControllerManager* controllers = nullptr;
+    InputState latched; // Edges from a poll that Capture() hasn't seen yet
+};
@@ -0,0 +1,315 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>    // For open
+#include <sys/mman.h> // For mmap
+#include <sys/stat.h> // For fstat
+#include <unistd.h>   // For close
+#if defined(__linux__)
+#include <sys/inotify.h>
+#else
+#include <ctime>
+#endif
+
+// Menu definitions read from a text file, reloaded while the game runs.
+//
+// The file is memory-mapped and parsed in one pass into flat arrays: menus,
+// their items and layout values, with every string stored once in a shared
+// character pool. One line per statement, '#' starts a comment:
+//
+//   layout <key> <number>          e.g. layout button_height 0.06
+//   menu <name> "<title>"          starts a menu; the items below belong to it
+//   item <key> ["<label>"]         an entry; without a label the game's default is used
+//
+// What keys, menus and layout values mean is up to the caller; this only
+// checks the syntax. Two tables are kept: a reload parses into the spare one
+// and swaps it in only if the whole file is valid, so a half-saved edit never
+// replaces a working menu, and after the first reloads neither table
+// reallocates unless the file grows.
+//
+// On Linux the file's directory is watched with inotify (editors often save
+// by renaming a new file over the old one, which a watch on the file itself
+// would lose); elsewhere the modification time is checked once a second.
+class MenuConfig {
+public:
+    // A [offset, offset + length) range of the character pool
+    struct Text {
+        uint32_t offset = 0;
+        uint32_t length = 0;
+    };
+
+    struct Menu {
+        Text name;
+        Text title;
+        uint32_t firstItem = 0;
+        uint32_t itemCount = 0;
+    };
+
+    struct Item {
+        Text key;
+        Text label; // Empty = no label given
+    };
+
+    struct Layout {
+        Text key;
+        float value = 0.0f;
+    };
+
+    ~MenuConfig() { StopWatching(); }
+
+    // Parses an in-memory definition, such as the built-in defaults, without watching anything
+    bool LoadFromMemory(const char* data, size_t size, const char* sourceName) {
+        if (!Parse(data, size, sourceName)) return false;
+        SwapTables();
+        return true;
+    }
+
+    // Maps and parses path; false (keeping the current table) if it is missing or invalid
+    bool LoadFile(const std::string& path) {
+        filePath = path;
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd == -1) return false;
+        struct stat info;
+        bool ok = false;
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            void* mapped = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED) {
+                ok = Parse((const char*)mapped, (size_t)info.st_size, path.c_str());
+                munmap(mapped, (size_t)info.st_size);
+            }
+        } else {
+            printf("[WARNING] Menu config %s is empty\n", path.c_str());
+        }
+        close(fd);
+        if (ok) SwapTables();
+        return ok;
+    }
+
+    // Goes back to the table in use before the last successful load, for a
+    // file that parsed but that the caller could not use
+    void Revert() { SwapTables(); }
+
+    // Starts watching the file last given to LoadFile() for edits
+    void Watch() {
+        StopWatching();
+        if (filePath.empty()) return;
+#if defined(__linux__)
+        size_t slash = filePath.find_last_of('/');
+        std::string directory = slash == std::string::npos ? "." : filePath.substr(0, slash);
+        fileName = slash == std::string::npos ? filePath : filePath.substr(slash + 1);
+        watchFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (watchFd == -1) return;
+        if (inotify_add_watch(watchFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) == -1) {
+            close(watchFd);
+            watchFd = -1;
+        }
+#else
+        lastModified = ModifiedTime();
+        lastCheck = time(nullptr);
+#endif
+    }
+
+    // Once per frame: reloads when the file changed. True if a new table is in use.
+    // Costs one non-blocking read() while nothing happens.
+    bool PollReload() {
+#if defined(__linux__)
+        if (watchFd == -1) return false;
+        alignas(struct inotify_event) char buffer[4096];
+        bool changed = false;
+        ssize_t length;
+        while ((length = read(watchFd, buffer, sizeof(buffer))) > 0) {
+            for (ssize_t at = 0; at < length;) {
+                const struct inotify_event* event = (const struct inotify_event*)(buffer + at);
+                if (event->len > 0 && fileName == event->name) changed = true;
+                at += sizeof(struct inotify_event) + event->len;
+            }
+        }
+        if (!changed) return false;
+#else
+        time_t now = time(nullptr);
+        if (filePath.empty() || now == lastCheck) return false;
+        lastCheck = now;
+        long modified = ModifiedTime();
+        if (modified == lastModified) return false;
+        lastModified = modified;
+#endif
+        return LoadFile(filePath);
+    }
+
+    void StopWatching() {
+#if defined(__linux__)
+        if (watchFd != -1) close(watchFd);
+        watchFd = -1;
+#endif
+    }
+
+    // Null when there is no menu with that name
+    const Menu* FindMenu(const char* name) const {
+        for (const Menu& menu : tables[current].menus) {
+            if (Equals(menu.name, name)) return &menu;
+        }
+        return nullptr;
+    }
+
+    const Item& GetItem(const Menu& menu, uint32_t index) const { return tables[current].items[menu.firstItem + index]; }
+
+    float GetLayout(const char* key, float fallback) const {
+        for (const Layout& layout : tables[current].layouts) {
+            if (Equals(layout.key, key)) return layout.value;
+        }
+        return fallback;
+    }
+
+    // Pointer into the pool; not NUL-terminated, use with the length
+    const char* GetText(Text text) const { return tables[current].pool.data() + text.offset; }
+
+    bool Equals(Text text, const char* value) const {
+        return strlen(value) == text.length && memcmp(GetText(text), value, text.length) == 0;
+    }
+
+private:
+    struct Table {
+        std::vector<Menu> menus;
+        std::vector<Item> items;
+        std::vector<Layout> layouts;
+        std::vector<char> pool;
+
+        void Clear() {
+            menus.clear();
+            items.clear();
+            layouts.clear();
+            pool.clear();
+        }
+    };
+
+    // Walks one line's tokens: bare words, numbers and "quoted strings"
+    struct Cursor {
+        const char* at;
+        const char* end;
+
+        void SkipSpace() {
+            while (at < end && (*at == ' ' || *at == '\t' || *at == '\r')) at++;
+        }
+
+        bool AtEnd() {
+            SkipSpace();
+            return at == end || *at == '#';
+        }
+
+        bool Word(const char*& start, size_t& length) {
+            if (AtEnd() || *at == '"') return false;
+            start = at;
+            while (at < end && *at != ' ' && *at != '\t' && *at != '\r' && *at != '#') at++;
+            length = (size_t)(at - start);
+            return true;
+        }
+
+        bool Quoted(const char*& start, size_t& length) {
+            if (AtEnd() || *at != '"') return false;
+            start = ++at;
+            while (at < end && *at != '"') at++;
+            if (at == end) return false;
+            length = (size_t)(at++ - start);
+            return true;
+        }
+    };
+
+    Text AddText(Table& table, const char* start, size_t length) {
+        Text text = {(uint32_t)table.pool.size(), (uint32_t)length};
+        table.pool.insert(table.pool.end(), start, start + length);
+        return text;
+    }
+
+    // Fills the spare table; false, with the reason printed, on the first bad line
+    bool Parse(const char* data, size_t size, const char* sourceName) {
+        Table& table = tables[1 - current];
+        table.Clear();
+        const char* end = data + size;
+        int lineNumber = 0;
+        for (const char* line = data; line < end;) {
+            const char* lineEnd = (const char*)memchr(line, '\n', (size_t)(end - line));
+            if (!lineEnd) lineEnd = end;
+            lineNumber++;
+            const char* lineStart = line;
+            Cursor cursor = {line, lineEnd};
+            line = lineEnd + 1;
+            if (cursor.AtEnd()) continue;
+
+            const char* word = nullptr;
+            size_t wordLength = 0;
+            const char* value;
+            size_t valueLength;
+            auto is = [&](const char* keyword) { return strlen(keyword) == wordLength && memcmp(word, keyword, wordLength) == 0; };
+            bool ok = false;
+            if (!cursor.Word(word, wordLength)) {
+                // Starts with a quote; no statement does
+            } else if (is("menu")) {
+                const char* title;
+                size_t titleLength;
+                ok = cursor.Word(value, valueLength) && cursor.Quoted(title, titleLength) && cursor.AtEnd();
+                if (ok) {
+                    Menu menu;
+                    menu.name = AddText(table, value, valueLength);
+                    menu.title = AddText(table, title, titleLength);
+                    menu.firstItem = (uint32_t)table.items.size();
+                    table.menus.push_back(menu);
+                }
+            } else if (is("item")) {
+                ok = !table.menus.empty() && cursor.Word(value, valueLength);
+                if (ok) {
+                    Item item;
+                    item.key = AddText(table, value, valueLength);
+                    const char* label;
+                    size_t labelLength;
+                    if (cursor.Quoted(label, labelLength)) item.label = AddText(table, label, labelLength);
+                    ok = cursor.AtEnd();
+                    table.items.push_back(item);
+                    table.menus.back().itemCount++;
+                }
+            } else if (is("layout")) {
+                const char* number;
+                size_t numberLength;
+                ok = cursor.Word(value, valueLength) && cursor.Word(number, numberLength) && cursor.AtEnd();
+                if (ok) {
+                    char digits[32] = {};
+                    memcpy(digits, number, std::min(numberLength, sizeof(digits) - 1));
+                    char* parsedEnd;
+                    Layout layout;
+                    layout.value = strtof(digits, &parsedEnd);
+                    ok = parsedEnd == digits + numberLength;
+                    layout.key = AddText(table, value, valueLength);
+                    table.layouts.push_back(layout);
+                }
+            }
+            if (!ok) {
+                printf("[WARNING] %s:%d: can't parse \"%.*s\"; menu config not loaded\n",
+                       sourceName, lineNumber, (int)(lineEnd - lineStart), lineStart);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void SwapTables() { current = 1 - current; }
+
+    Table tables[2];
+    int current = 0;
+    std::string filePath;
+#if defined(__linux__)
+    std::string fileName;
+    int watchFd = -1;
+#else
+    long ModifiedTime() const {
+        struct stat info;
+        return stat(filePath.c_str(), &info) == 0 ? (long)info.st_mtime : 0;
+    }
+    long lastModified = 0;
+    time_t lastCheck = 0;
+#endif
+};
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+// Integrate-and-clamp kernels behind MoveEntities().
+//
+// Each kernel moves count entities by velocity * dt, clamps them inside
+// [0, width - size] x [0, height - size] and negates the velocity component
+// of any axis that was clamped. All variants do the same IEEE operations in
+// the same order and the SIMD ones never fuse the multiply-add, so they match
+// the scalar path bit for bit unless the compiler contracts the scalar loop
+// into FMAs (GCC does on AArch64). They differ only in how many entities they
+// handle per instruction.
+//
+// The best kernel the CPU supports is picked once at runtime. Set
+// GAME_MOVE_KERNEL=scalar|sse|avx2|neon to force one (unsupported names fall
+// back to the automatic choice).
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MOVE_KERNELS_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(__ARM_NEON)
+#define MOVE_KERNELS_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace move_kernels {
+
+using MoveFn = void (*)(float* px, float* py, float* vx, float* vy, const float* sz,
+                        uint32_t count, float dt, float width, float height);
+
+struct MoveKernel {
+    const char* name;
+    MoveFn fn;
+};
+
+// Reference version, also used for the tail of every SIMD kernel
+inline void MoveScalar(float* __restrict px, float* __restrict py, float* __restrict vx, float* __restrict vy,
+                       const float* __restrict sz, uint32_t count, float dt, float width, float height) {
+    for (uint32_t i = 0; i < count; i++) {
+        float x = px[i] + vx[i] * dt;
+        float y = py[i] + vy[i] * dt;
+        float cx = std::min(std::max(x, 0.0f), width - sz[i]);
+        float cy = std::min(std::max(y, 0.0f), height - sz[i]);
+        vx[i] = cx != x ? -vx[i] : vx[i];
+        vy[i] = cy != y ? -vy[i] : vy[i];
+        px[i] = cx;
+        py[i] = cy;
+    }
+}
+
+#if MOVE_KERNELS_X86
+
+// SSE is part of the x86-64 baseline; the target attribute covers 32-bit builds
+__attribute__((target("sse2")))
+inline void MoveSSE(float* px, float* py, float* vx, float* vy, const float* sz,
+                    uint32_t count, float dt, float width, float height) {
+    const __m128 vdt = _mm_set1_ps(dt);
+    const __m128 vw = _mm_set1_ps(width);
+    const __m128 vh = _mm_set1_ps(height);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 sign = _mm_set1_ps(-0.0f);
+
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 s = _mm_loadu_ps(sz + i);
+        __m128 velX = _mm_loadu_ps(vx + i);
+        __m128 velY = _mm_loadu_ps(vy + i);
+        __m128 x = _mm_add_ps(_mm_loadu_ps(px + i), _mm_mul_ps(velX, vdt));
+        __m128 y = _mm_add_ps(_mm_loadu_ps(py + i), _mm_mul_ps(velY, vdt));
+        // Operand order matches std::max/std::min exactly, including signed zeros
+        __m128 cx = _mm_min_ps(_mm_sub_ps(vw, s), _mm_max_ps(zero, x));
+        __m128 cy = _mm_min_ps(_mm_sub_ps(vh, s), _mm_max_ps(zero, y));
+        // Flip the sign bit wherever the clamp changed the value
+        velX = _mm_xor_ps(velX, _mm_and_ps(_mm_cmpneq_ps(cx, x), sign));
+        velY = _mm_xor_ps(velY, _mm_and_ps(_mm_cmpneq_ps(cy, y), sign));
+        _mm_storeu_ps(vx + i, velX);
+        _mm_storeu_ps(vy + i, velY);
+        _mm_storeu_ps(px + i, cx);
+        _mm_storeu_ps(py + i, cy);
+    }
+    MoveScalar(px + i, py + i, vx + i, vy + i, sz + i, count - i, dt, width, height);
+}
+
+__attribute__((target("avx2")))
+inline void MoveAVX2(float* px, float* py, float* vx, float* vy, const float* sz,
+                     uint32_t count, float dt, float width, float height) {
+    const __m256 vdt = _mm256_set1_ps(dt);
+    const __m256 vw = _mm256_set1_ps(width);
+    const __m256 vh = _mm256_set1_ps(height);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 s = _mm256_loadu_ps(sz + i);
+        __m256 velX = _mm256_loadu_ps(vx + i);
+        __m256 velY = _mm256_loadu_ps(vy + i);
+        __m256 x = _mm256_add_ps(_mm256_loadu_ps(px + i), _mm256_mul_ps(velX, vdt));
+        __m256 y = _mm256_add_ps(_mm256_loadu_ps(py + i), _mm256_mul_ps(velY, vdt));
+        __m256 cx = _mm256_min_ps(_mm256_sub_ps(vw, s), _mm256_max_ps(zero, x));
+        __m256 cy = _mm256_min_ps(_mm256_sub_ps(vh, s), _mm256_max_ps(zero, y));
+        velX = _mm256_xor_ps(velX, _mm256_and_ps(_mm256_cmp_ps(cx, x, _CMP_NEQ_UQ), sign));
+        velY = _mm256_xor_ps(velY, _mm256_and_ps(_mm256_cmp_ps(cy, y, _CMP_NEQ_UQ), sign));
+        _mm256_storeu_ps(vx + i, velX);
+        _mm256_storeu_ps(vy + i, velY);
+        _mm256_storeu_ps(px + i, cx);
+        _mm256_storeu_ps(py + i, cy);
+    }
+    MoveScalar(px + i, py + i, vx + i, vy + i, sz + i, count - i, dt, width, height);
+}
+
+#endif // MOVE_KERNELS_X86
+
+#if MOVE_KERNELS_NEON
+
+inline void MoveNEON(float* px, float* py, float* vx, float* vy, const float* sz,
+                     uint32_t count, float dt, float width, float height) {
+    const float32x4_t vdt = vdupq_n_f32(dt);
+    const float32x4_t vw = vdupq_n_f32(width);
+    const float32x4_t vh = vdupq_n_f32(height);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const uint32x4_t sign = vdupq_n_u32(0x80000000u);
+
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t s = vld1q_f32(sz + i);
+        float32x4_t velX = vld1q_f32(vx + i);
+        float32x4_t velY = vld1q_f32(vy + i);
+        // Separate multiply and add (vmlaq may fuse) to match the scalar rounding
+        float32x4_t x = vaddq_f32(vld1q_f32(px + i), vmulq_f32(velX, vdt));
+        float32x4_t y = vaddq_f32(vld1q_f32(py + i), vmulq_f32(velY, vdt));
+        // Compare-and-select rather than vmaxq/vminq, which treat signed zeros differently from std::max/std::min
+        float32x4_t hiX = vsubq_f32(vw, s);
+        float32x4_t hiY = vsubq_f32(vh, s);
+        float32x4_t cx = vbslq_f32(vcltq_f32(x, zero), zero, x);
+        float32x4_t cy = vbslq_f32(vcltq_f32(y, zero), zero, y);
+        cx = vbslq_f32(vcltq_f32(hiX, cx), hiX, cx);
+        cy = vbslq_f32(vcltq_f32(hiY, cy), hiY, cy);
+        uint32x4_t flipX = vandq_u32(vmvnq_u32(vceqq_f32(cx, x)), sign);
+        uint32x4_t flipY = vandq_u32(vmvnq_u32(vceqq_f32(cy, y)), sign);
+        velX = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(velX), flipX));
+        velY = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(velY), flipY));
+        vst1q_f32(vx + i, velX);
+        vst1q_f32(vy + i, velY);
+        vst1q_f32(px + i, cx);
+        vst1q_f32(py + i, cy);
+    }
+    MoveScalar(px + i, py + i, vx + i, vy + i, sz + i, count - i, dt, width, height);
+}
+
+#endif // MOVE_KERNELS_NEON
+
+// Every kernel this build and CPU can run, best first; the last is always scalar
+inline int GetAvailableKernels(MoveKernel* out, int capacity) {
+    int count = 0;
+    auto add = [&](const char* name, MoveFn fn) {
+        if (count < capacity) out[count++] = {name, fn};
+    };
+#if MOVE_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) add("avx2", MoveAVX2);
+    if (__builtin_cpu_supports("sse2")) add("sse", MoveSSE);
+#endif
+#if MOVE_KERNELS_NEON
+    add("neon", MoveNEON);
+#endif
+    add("scalar", MoveScalar);
+    return count;
+}
+
+inline MoveKernel SelectKernel() {
+    MoveKernel kernels[4];
+    int count = GetAvailableKernels(kernels, 4);
+    if (const char* forced = getenv("GAME_MOVE_KERNEL")) {
+        for (int i = 0; i < count; i++) {
+            if (strcmp(forced, kernels[i].name) == 0) return kernels[i];
+        }
+    }
+    return kernels[0];
+}
+
+// Chosen on first use, then fixed for the life of the process
+inline const MoveKernel& GetMoveKernel() {
+    static const MoveKernel kernel = SelectKernel();
+    return kernel;
+}
+
+} // namespace move_kernels
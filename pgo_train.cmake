@@ -0,0 +1,48 @@
+# Training runs for a GAME_PGO=GENERATE build; run it with the pgo_train target,
+# which passes the paths below.
+#
+#   BENCH, GAME   the instrumented game_bench and game
+#   PROFILE_DIR   where the instrumented binaries write their profile
+#   LOG_DIR       optional directory of recorded .rtin input logs
+#   WORK_DIR      scratch space for the log recorded here
+#   PROFDATA      llvm-profdata, Clang only: merges the raw profiles into game.profdata
+#
+# The bench's scripted scenario runs once small and once with a large world, and
+# is recorded on the way so the game binary can replay it too (game_bench and
+# game are separate programs with separate profiles). Every log in LOG_DIR then
+# plays through both, so the profile follows what players actually do.
+
+# Stale counters from an older build would be merged in or rejected; start over
+file(REMOVE_RECURSE ${PROFILE_DIR} ${WORK_DIR})
+file(MAKE_DIRECTORY ${PROFILE_DIR} ${WORK_DIR})
+
+function(train)
+    string(REPLACE ";" " " command "${ARGN}")
+    message(STATUS "PGO training: ${command}")
+    execute_process(COMMAND ${ARGN} RESULT_VARIABLE result OUTPUT_QUIET ERROR_QUIET)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "PGO training run failed (${result}): ${command}")
+    endif()
+endfunction()
+
+set(scripted ${WORK_DIR}/scripted.rtin)
+train(${BENCH} --frames 3000 --record ${scripted})
+train(${BENCH} --frames 600 --entities 100000)
+
+set(logs ${scripted})
+if(LOG_DIR)
+    file(GLOB recorded ${LOG_DIR}/*.rtin)
+    list(SORT recorded)
+    list(APPEND logs ${recorded})
+endif()
+foreach(log ${logs})
+    train(${BENCH} --replay ${log})
+    train(${CMAKE_COMMAND} -E env GAME_REPLAY_INPUT=${log} ${GAME})
+endforeach()
+
+if(PROFDATA)
+    file(GLOB raw ${PROFILE_DIR}/*.profraw)
+    train(${PROFDATA} merge -output=${PROFILE_DIR}/game.profdata ${raw})
+endif()
+list(LENGTH logs count)
+message(STATUS "PGO training done: ${count} replayed logs; reconfigure with -DGAME_PGO=USE and rebuild")
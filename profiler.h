@@ -0,0 +1,270 @@
+#pragma once
+
+// Frame profiler: per-phase CPU timings for the last few hundred frames.
+//
+// Compiled in when GAME_PROFILER is 1. By default that is every build without
+// NDEBUG, so CMake Release builds drop it entirely; pass -DGAME_PROFILER=0/1
+// to override. When disabled, PROFILE_* macros expand to nothing.
+
+#ifndef GAME_PROFILER
+#ifdef NDEBUG
+#define GAME_PROFILER 0
+#else
+#define GAME_PROFILER 1
+#endif
+#endif
+
+// Timed phases of a frame
+enum class ProfileZone {
+    INPUT,
+    UPDATE_MENU,
+    UPDATE_GAME,
+    SIMULATE,    // Entity systems, once per simulation tick; nested inside UpdateGame
+    UPDATE_PAUSED,
+    DRAW_MENU,
+    DRAW_GAME,
+    DRAW_PAUSED,
+    END_DRAWING, // Buffer swap, vsync and SetTargetFPS wait
+    SAVE_GAME,   // Nested inside whichever update triggered the save
+    PACE_WAIT,   // Low-latency mode's sleep before input is sampled
+    FRAME,       // Whole frame, start to start
+    COUNT
+};
+
+inline const char* GetProfileZoneName(ProfileZone zone) {
+    switch (zone) {
+        case ProfileZone::INPUT: return "CheckInputMode";
+        case ProfileZone::UPDATE_MENU: return "UpdateMenu";
+        case ProfileZone::UPDATE_GAME: return "UpdateGame";
+        case ProfileZone::SIMULATE: return "Simulate";
+        case ProfileZone::UPDATE_PAUSED: return "UpdatePaused";
+        case ProfileZone::DRAW_MENU: return "DrawMenu";
+        case ProfileZone::DRAW_GAME: return "DrawGame";
+        case ProfileZone::DRAW_PAUSED: return "DrawPaused";
+        case ProfileZone::END_DRAWING: return "EndDrawing";
+        case ProfileZone::SAVE_GAME: return "SaveGame";
+        case ProfileZone::PACE_WAIT: return "PaceWait";
+        case ProfileZone::FRAME: return "Frame";
+        default: return "?";
+    }
+}
+
+#if GAME_PROFILER
+
+#include "alloc_counter.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+class FrameProfiler {
+public:
+    static constexpr int HISTORY_FRAMES = 240;
+    static constexpr int ZONE_COUNT = (int)ProfileZone::COUNT;
+    static constexpr int ALLOC_TAG_COUNT = (int)AllocTag::COUNT;
+
+    using Clock = std::chrono::steady_clock;
+
+    struct FrameRecord {
+        std::array<uint32_t, ZONE_COUNT> nanos; // Time spent per zone
+        std::array<uint16_t, ZONE_COUNT> calls; // Times each zone was entered
+        uint32_t activeZones;                   // Bit per zone entered this frame
+        uint32_t allocations;                   // Heap allocations on the frame thread
+        std::array<uint32_t, ALLOC_TAG_COUNT> taggedAllocations; // Per tag, on every thread
+        uint32_t inputLatency;                  // Nanoseconds from oldest input event to present, 0 = no input
+
+        bool IsActive(ProfileZone zone) const { return (activeZones >> (int)zone) & 1u; }
+        float GetMs(ProfileZone zone) const { return nanos[(int)zone] / 1000000.0f; }
+    };
+
+    struct ZoneStats {
+        float avgMs = 0.0f;
+        float p99Ms = 0.0f;
+        float maxMs = 0.0f;
+    };
+
+    struct AllocRate {
+        float meanPerFrame = 0.0f; // Over the frames in the history, every thread
+        uint32_t maxPerFrame = 0;
+    };
+
+    struct LatencyStats {
+        int samples = 0; // Frames in the history that carried input
+        float p50Ms = 0.0f;
+        float p95Ms = 0.0f;
+        float p99Ms = 0.0f;
+        float maxMs = 0.0f;
+    };
+
+    // Closes the previous frame (committing it to the history) and opens a new one
+    void NextFrame() {
+        Clock::time_point now = Clock::now();
+        uint64_t allocations = GetThreadAllocationCount();
+        std::array<uint64_t, ALLOC_TAG_COUNT> tagged;
+        for (int i = 0; i < ALLOC_TAG_COUNT; i++) tagged[i] = GetAllocTagStats((AllocTag)i).allocations;
+        if (frameOpen) {
+            AddSample(ProfileZone::FRAME, now - frameStart);
+            current.allocations = (uint32_t)std::min<uint64_t>(allocations - frameStartAllocations, UINT32_MAX);
+            for (int i = 0; i < ALLOC_TAG_COUNT; i++) {
+                current.taggedAllocations[i] = (uint32_t)std::min<uint64_t>(tagged[i] - frameStartTagged[i], UINT32_MAX);
+            }
+            uint64_t index = committedFrames.load(std::memory_order_relaxed);
+            history[index % HISTORY_FRAMES] = current;
+            // Publish the slot only after it is fully written
+            committedFrames.store(index + 1, std::memory_order_release);
+        }
+        current = FrameRecord{};
+        frameStart = now;
+        frameStartAllocations = allocations;
+        frameStartTagged = tagged;
+        frameOpen = true;
+    }
+
+    void AddSample(ProfileZone zone, Clock::duration elapsed) {
+        // Zones entered more than once per frame accumulate
+        current.nanos[(int)zone] += ToNanos(elapsed);
+        current.calls[(int)zone]++;
+        current.activeZones |= 1u << (int)zone;
+    }
+
+    // The current frame's input-to-present time; see FramePacer
+    void SetInputLatency(Clock::duration latency) {
+        current.inputLatency = std::max<uint32_t>(1, ToNanos(latency));
+    }
+
+    uint64_t GetFrameCount() const {
+        return committedFrames.load(std::memory_order_acquire);
+    }
+
+    // Most recently committed frame; false before the first one
+    bool GetLatestFrame(FrameRecord& out) const {
+        uint64_t frames = GetFrameCount();
+        if (frames == 0) return false;
+        out = history[(frames - 1) % HISTORY_FRAMES];
+        return true;
+    }
+
+    // Statistics over the frames in the history that entered the zone
+    ZoneStats GetStats(ProfileZone zone) const {
+        ZoneStats stats;
+        uint64_t frames = GetFrameCount();
+        int available = (int)std::min<uint64_t>(frames, HISTORY_FRAMES);
+
+        std::array<uint32_t, HISTORY_FRAMES> samples;
+        int count = 0;
+        uint64_t total = 0;
+        for (int i = 0; i < available; i++) {
+            const FrameRecord& record = history[(frames - 1 - i) % HISTORY_FRAMES];
+            if (!record.IsActive(zone)) continue;
+            uint32_t value = record.nanos[(int)zone];
+            samples[count++] = value;
+            total += value;
+            stats.maxMs = std::max(stats.maxMs, value / 1000000.0f);
+        }
+        if (count == 0) return stats;
+
+        int p99Index = std::min(count - 1, (count * 99) / 100);
+        std::nth_element(samples.begin(), samples.begin() + p99Index, samples.begin() + count);
+        stats.avgMs = (float)total / count / 1000000.0f;
+        stats.p99Ms = samples[p99Index] / 1000000.0f;
+        return stats;
+    }
+
+    // Percentiles over the frames in the history that carried input
+    LatencyStats GetInputLatencyStats() const {
+        LatencyStats stats;
+        uint64_t frames = GetFrameCount();
+        int available = (int)std::min<uint64_t>(frames, HISTORY_FRAMES);
+
+        std::array<uint32_t, HISTORY_FRAMES> samples;
+        int count = 0;
+        for (int i = 0; i < available; i++) {
+            uint32_t value = history[(frames - 1 - i) % HISTORY_FRAMES].inputLatency;
+            if (value != 0) samples[count++] = value;
+        }
+        stats.samples = count;
+        if (count == 0) return stats;
+
+        std::sort(samples.begin(), samples.begin() + count);
+        auto percentile = [&](int p) { return samples[std::min(count - 1, (count * p) / 100)] / 1000000.0f; };
+        stats.p50Ms = percentile(50);
+        stats.p95Ms = percentile(95);
+        stats.p99Ms = percentile(99);
+        stats.maxMs = samples[count - 1] / 1000000.0f;
+        return stats;
+    }
+
+    // Largest per-frame allocation count in the history
+    uint32_t GetMaxAllocations() const {
+        uint64_t frames = GetFrameCount();
+        int available = (int)std::min<uint64_t>(frames, HISTORY_FRAMES);
+        uint32_t maxAllocations = 0;
+        for (int i = 0; i < available; i++) {
+            maxAllocations = std::max(maxAllocations, history[(frames - 1 - i) % HISTORY_FRAMES].allocations);
+        }
+        return maxAllocations;
+    }
+
+    // Allocations charged to tag per frame over the history
+    AllocRate GetAllocRate(AllocTag tag) const {
+        uint64_t frames = GetFrameCount();
+        int available = (int)std::min<uint64_t>(frames, HISTORY_FRAMES);
+        AllocRate rate;
+        if (available == 0) return rate;
+        uint64_t total = 0;
+        for (int i = 0; i < available; i++) {
+            uint32_t count = history[(frames - 1 - i) % HISTORY_FRAMES].taggedAllocations[(int)tag];
+            total += count;
+            rate.maxPerFrame = std::max(rate.maxPerFrame, count);
+        }
+        rate.meanPerFrame = (float)total / available;
+        return rate;
+    }
+
+private:
+    static uint32_t ToNanos(Clock::duration d) {
+        long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+        return (uint32_t)std::min<long long>(ns, UINT32_MAX); // Saturate on multi-second stalls
+    }
+
+    std::array<FrameRecord, HISTORY_FRAMES> history{};
+    std::atomic<uint64_t> committedFrames{0};
+    FrameRecord current{};
+    Clock::time_point frameStart;
+    uint64_t frameStartAllocations = 0;
+    std::array<uint64_t, ALLOC_TAG_COUNT> frameStartTagged{};
+    bool frameOpen = false;
+};
+
+// Times the enclosing scope into one zone
+class ProfileScope {
+public:
+    ProfileScope(FrameProfiler& profiler, ProfileZone zone)
+        : profiler(profiler), zone(zone), start(FrameProfiler::Clock::now()) {}
+    ~ProfileScope() { profiler.AddSample(zone, FrameProfiler::Clock::now() - start); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    FrameProfiler& profiler;
+    ProfileZone zone;
+    FrameProfiler::Clock::time_point start;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(profiler, zone) ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(profiler, zone)
+#define PROFILE_NEXT_FRAME(profiler) (profiler).NextFrame()
+#define PROFILE_INPUT_LATENCY(profiler, latency) (profiler).SetInputLatency(latency)
+#define PROFILE_ALLOC_TAG(tag) AllocTagScope PROFILE_CONCAT(allocTagScope_, __LINE__)(tag)
+
+#else
+
+#define PROFILE_SCOPE(profiler, zone) ((void)0)
+#define PROFILE_NEXT_FRAME(profiler) ((void)0)
+#define PROFILE_INPUT_LATENCY(profiler, latency) ((void)0)
+#define PROFILE_ALLOC_TAG(tag) ((void)0)
+
+#endif
@@ -0,0 +1,329 @@
+#pragma once
+
+#include "raylib.h"
+#include "raymath.h" // For MatrixMultiply
+#include "rlgl.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Collects colored (optionally textured) axis-aligned quads for a frame and
+// submits them in as few draw calls as possible.
+//
+// Quads are bucketed by (layer, texture) as they are added and each bucket
+// keeps submission order, so lower layers always end up underneath and a
+// texture switch costs one draw call per layer instead of one per quad.
+//
+// On OpenGL 3.3+ every bucket is drawn with one instanced call per CHUNK_QUADS
+// quads: a static unit quad plus per-instance rect and color buffers that are
+// created once and refilled each flush. Buckets that sample texture regions
+// (glyphs from an atlas) also fill a per-instance UV buffer; the rest leave
+// that attribute at its constant whole-texture default, so untextured quads
+// upload nothing extra. Older GL versions fall back to
+// feeding the same buckets through rlgl's own batch (rlBegin/rlVertex), which
+// still merges them into a few draw calls.
+//
+// Anything raylib already queued is flushed before the batch draws, and text
+// drawn after Flush() lands on top, so call Flush() wherever the quads must be
+// underneath later raylib drawing.
+class QuadBatch {
+public:
+    static constexpr int CHUNK_QUADS = 16384; // Instances uploaded per instanced draw call
+
+    struct Stats {
+        int drawCalls = 0;
+        int vertices = 0;
+        int quads = 0;
+    };
+
+    // Needs a GL context, i.e. call after InitWindow()
+    void Init() {
+        int version = rlGetVersion();
+        instanced = version == RL_OPENGL_33 || version == RL_OPENGL_43;
+        if (instanced && !InitInstancing()) {
+            ShutdownInstancing();
+            instanced = false;
+        }
+    }
+
+    // Call before CloseWindow()
+    void Shutdown() {
+        ShutdownInstancing();
+        buckets.clear();
+    }
+
+    bool IsInstanced() const { return instanced; }
+
+    void AddRect(Rectangle rect, Color color, int layer = 0) {
+        PushQuad(rect, color, layer, 0);
+    }
+
+    // Outline drawn as four quads inside rect, like DrawRectangleLinesEx
+    void AddRectLines(Rectangle rect, float thickness, Color color, int layer = 0) {
+        float t = std::min(thickness, std::min(rect.width, rect.height) / 2);
+        PushQuad({rect.x, rect.y, rect.width, t}, color, layer, 0);
+        PushQuad({rect.x, rect.y + rect.height - t, rect.width, t}, color, layer, 0);
+        PushQuad({rect.x, rect.y + t, t, rect.height - 2 * t}, color, layer, 0);
+        PushQuad({rect.x + rect.width - t, rect.y + t, t, rect.height - 2 * t}, color, layer, 0);
+    }
+
+    // Space for count untextured quads, filled in by the caller. The arrays stay
+    // valid until the next Add*/Append/Flush call, so disjoint parts of them can
+    // be written from several threads.
+    struct QuadSpan {
+        Rectangle* rects;
+        Color* colors;
+    };
+
+    QuadSpan AppendRects(uint32_t count, int layer = 0) {
+        Bucket& bucket = buckets[FindBucket(layer, 0)];
+        size_t start = bucket.rects.size();
+        bucket.rects.resize(start + count);
+        bucket.colors.resize(start + count);
+        if (!bucket.uvs.empty()) bucket.uvs.resize(start + count, FULL_UV);
+        return {bucket.rects.data() + start, bucket.colors.data() + start};
+    }
+
+    // Whole texture stretched over dest, tinted
+    void AddTexture(Texture2D texture, Rectangle dest, Color tint, int layer = 0) {
+        PushQuad(dest, tint, layer, texture.id);
+    }
+
+    // The part of texture inside source (in texels) stretched over dest, tinted.
+    // Unlike DrawTexturePro(), a negative height is not shifted: source.y is the
+    // edge the quad's top samples from, so a flipped region starts at its bottom row
+    void AddTextureRegion(Texture2D texture, Rectangle source, Rectangle dest, Color tint, int layer = 0) {
+        if (texture.width <= 0 || texture.height <= 0) return;
+        Rectangle uv = {source.x / texture.width, source.y / texture.height,
+                        source.width / texture.width, source.height / texture.height};
+        Bucket& bucket = buckets[FindBucket(layer, texture.id)];
+        bucket.uvs.resize(bucket.rects.size(), FULL_UV); // Quads added before this one used the whole texture
+        bucket.rects.push_back(dest);
+        bucket.colors.push_back(tint);
+        bucket.uvs.push_back(uv);
+    }
+
+    // Draws everything added since the last Flush(), lowest layer first
+    void Flush() {
+        Submit();
+        Clear();
+    }
+
+    // Draws what has been added like Flush() but keeps it, so the same quads
+    // can be drawn again, e.g. once per split-screen view, until Clear()
+    void Submit() {
+        int pending = 0;
+        for (const Bucket& bucket : buckets) pending += (int)bucket.rects.size();
+        if (pending == 0) return;
+
+        rlDrawRenderBatchActive(); // Keep earlier raylib drawing underneath
+
+        order.clear();
+        for (int i = 0; i < (int)buckets.size(); i++) {
+            if (!buckets[i].rects.empty()) order.push_back(i);
+        }
+        std::sort(order.begin(), order.end(), [this](int a, int b) {
+            if (buckets[a].layer != buckets[b].layer) return buckets[a].layer < buckets[b].layer;
+            return buckets[a].texture < buckets[b].texture;
+        });
+
+        if (instanced) {
+            DrawInstanced();
+        } else {
+            DrawImmediate();
+        }
+        for (const Bucket& bucket : buckets) stats.quads += (int)bucket.rects.size();
+    }
+
+    // Drops everything added without drawing it
+    void Clear() {
+        for (Bucket& bucket : buckets) {
+            bucket.rects.clear();
+            bucket.colors.clear();
+            bucket.uvs.clear();
+        }
+    }
+
+    // Counters since the last ResetStats(); Game resets them every frame
+    const Stats& GetStats() const { return stats; }
+    void ResetStats() { stats = Stats(); }
+
+private:
+    static constexpr Rectangle FULL_UV = {0.0f, 0.0f, 1.0f, 1.0f};
+
+    struct Bucket {
+        int layer;
+        unsigned int texture; // 0 = rlgl's default white texture
+        std::vector<Rectangle> rects;
+        std::vector<Color> colors;
+        std::vector<Rectangle> uvs; // Normalized texture region per quad; empty = whole texture for all
+    };
+
+    int FindBucket(int layer, unsigned int texture) {
+        // Consecutive quads almost always share a bucket
+        if (lastBucket < 0 || buckets[lastBucket].layer != layer || buckets[lastBucket].texture != texture) {
+            lastBucket = -1;
+            for (int i = 0; i < (int)buckets.size() && lastBucket < 0; i++) {
+                if (buckets[i].layer == layer && buckets[i].texture == texture) lastBucket = i;
+            }
+            if (lastBucket < 0) {
+                buckets.push_back({layer, texture, {}, {}, {}});
+                lastBucket = (int)buckets.size() - 1;
+            }
+        }
+        return lastBucket;
+    }
+
+    void PushQuad(Rectangle rect, Color color, int layer, unsigned int texture) {
+        Bucket& bucket = buckets[FindBucket(layer, texture)];
+        bucket.rects.push_back(rect);
+        bucket.colors.push_back(color);
+        if (!bucket.uvs.empty()) bucket.uvs.push_back(FULL_UV);
+    }
+
+    unsigned int TextureFor(const Bucket& bucket) const {
+        return bucket.texture != 0 ? bucket.texture : rlGetTextureIdDefault();
+    }
+
+    bool InitInstancing() {
+        static const char* vertexShader = R"(#version 330
+layout(location = 0) in vec2 corner;   // Unit quad, 0-1
+layout(location = 1) in vec4 rect;     // Per instance: x, y, width, height
+layout(location = 2) in vec4 color;    // Per instance, normalized bytes
+layout(location = 3) in vec4 uv;       // Per instance texture region: u, v, width, height
+out vec2 fragTexCoord;
+out vec4 fragColor;
+uniform mat4 mvp;
+void main() {
+    fragTexCoord = uv.xy + corner * uv.zw;
+    fragColor = color;
+    gl_Position = mvp * vec4(rect.xy + corner * rect.zw, 0.0, 1.0);
+}
+)";
+        static const char* fragmentShader = R"(#version 330
+in vec2 fragTexCoord;
+in vec4 fragColor;
+out vec4 finalColor;
+uniform sampler2D texture0;
+void main() {
+    finalColor = texture(texture0, fragTexCoord) * fragColor;
+}
+)";
+        shader = LoadShaderFromMemory(vertexShader, fragmentShader);
+        if (shader.id == 0 || shader.id == rlGetShaderIdDefault()) return false; // Compile failure falls back to the default shader
+        mvpLoc = GetShaderLocation(shader, "mvp");
+        textureLoc = GetShaderLocation(shader, "texture0");
+
+        // Two triangles; rlDrawVertexArrayInstanced draws GL_TRIANGLES
+        static const float corners[12] = {0, 0, 0, 1, 1, 1, 0, 0, 1, 1, 1, 0};
+
+        // One buffer per attribute, each starting at offset 0 (rlSetVertexAttribute's
+        // last parameter is a pointer in some raylib versions and an int in others)
+        vao = rlLoadVertexArray();
+        if (vao == 0) return false;
+        rlEnableVertexArray(vao);
+        cornerVbo = rlLoadVertexBuffer(corners, sizeof(corners), false);
+        rlSetVertexAttribute(0, 2, RL_FLOAT, false, 0, 0);
+        rlEnableVertexAttribute(0);
+        rectVbo = rlLoadVertexBuffer(nullptr, CHUNK_QUADS * sizeof(Rectangle), true);
+        rlSetVertexAttribute(1, 4, RL_FLOAT, false, 0, 0);
+        rlEnableVertexAttribute(1);
+        rlSetVertexAttributeDivisor(1, 1);
+        colorVbo = rlLoadVertexBuffer(nullptr, CHUNK_QUADS * sizeof(Color), true);
+        rlSetVertexAttribute(2, 4, RL_UNSIGNED_BYTE, true, 0, 0);
+        rlEnableVertexAttribute(2);
+        rlSetVertexAttributeDivisor(2, 1);
+        uvVbo = rlLoadVertexBuffer(nullptr, CHUNK_QUADS * sizeof(Rectangle), true);
+        rlSetVertexAttribute(3, 4, RL_FLOAT, false, 0, 0);
+        rlSetVertexAttributeDivisor(3, 1);
+        rlDisableVertexArray();
+        return cornerVbo != 0 && rectVbo != 0 && colorVbo != 0 && uvVbo != 0;
+    }
+
+    void ShutdownInstancing() {
+        if (vao != 0) rlUnloadVertexArray(vao);
+        if (cornerVbo != 0) rlUnloadVertexBuffer(cornerVbo);
+        if (rectVbo != 0) rlUnloadVertexBuffer(rectVbo);
+        if (colorVbo != 0) rlUnloadVertexBuffer(colorVbo);
+        if (uvVbo != 0) rlUnloadVertexBuffer(uvVbo);
+        if (shader.id != 0 && shader.id != rlGetShaderIdDefault()) UnloadShader(shader);
+        vao = cornerVbo = rectVbo = colorVbo = uvVbo = 0;
+        shader = Shader{};
+    }
+
+    void DrawInstanced() {
+        rlEnableShader(shader.id);
+        rlSetUniformMatrix(mvpLoc, MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection()));
+        int textureSlot = 0;
+        rlSetUniform(textureLoc, &textureSlot, RL_SHADER_UNIFORM_INT, 1);
+        rlActiveTextureSlot(0);
+        rlEnableVertexArray(vao);
+
+        for (int index : order) {
+            const Bucket& bucket = buckets[index];
+            rlEnableTexture(TextureFor(bucket));
+            bool regions = !bucket.uvs.empty();
+            if (regions) {
+                rlEnableVertexAttribute(3);
+            } else {
+                rlDisableVertexAttribute(3);
+                rlSetVertexAttributeDefault(3, &FULL_UV, RL_SHADER_ATTRIB_VEC4, 4);
+            }
+            int count = (int)bucket.rects.size();
+            for (int start = 0; start < count; start += CHUNK_QUADS) {
+                int chunk = std::min(CHUNK_QUADS, count - start);
+                rlUpdateVertexBuffer(rectVbo, bucket.rects.data() + start, chunk * (int)sizeof(Rectangle), 0);
+                rlUpdateVertexBuffer(colorVbo, bucket.colors.data() + start, chunk * (int)sizeof(Color), 0);
+                if (regions) rlUpdateVertexBuffer(uvVbo, bucket.uvs.data() + start, chunk * (int)sizeof(Rectangle), 0);
+                rlDrawVertexArrayInstanced(0, 6, chunk);
+                stats.drawCalls++;
+                stats.vertices += chunk * 6;
+            }
+        }
+
+        rlDisableVertexArray();
+        rlDisableTexture();
+        rlDisableShader();
+    }
+
+    void DrawImmediate() {
+        for (int index : order) {
+            const Bucket& bucket = buckets[index];
+            rlSetTexture(TextureFor(bucket));
+            rlBegin(RL_QUADS);
+            for (size_t i = 0; i < bucket.rects.size(); i++) {
+                // Starts a new rlgl draw when its vertex buffer is full
+                if (rlCheckRenderBatchLimit(4)) stats.drawCalls++;
+                const Rectangle& r = bucket.rects[i];
+                const Color& c = bucket.colors[i];
+                const Rectangle& t = bucket.uvs.empty() ? FULL_UV : bucket.uvs[i];
+                rlColor4ub(c.r, c.g, c.b, c.a);
+                // Counter-clockwise, as raylib's own shapes
+                rlTexCoord2f(t.x, t.y); rlVertex2f(r.x, r.y);
+                rlTexCoord2f(t.x, t.y + t.height); rlVertex2f(r.x, r.y + r.height);
+                rlTexCoord2f(t.x + t.width, t.y + t.height); rlVertex2f(r.x + r.width, r.y + r.height);
+                rlTexCoord2f(t.x + t.width, t.y); rlVertex2f(r.x + r.width, r.y);
+            }
+            rlEnd();
+            rlSetTexture(0);
+            stats.drawCalls++; // One rlgl draw per texture run
+            stats.vertices += (int)bucket.rects.size() * 4;
+        }
+        rlDrawRenderBatchActive();
+    }
+
+    std::vector<Bucket> buckets; // Kept between frames so their storage is reused
+    std::vector<int> order;
+    int lastBucket = -1;
+    Stats stats;
+
+    bool instanced = false;
+    Shader shader = {};
+    int mvpLoc = -1;
+    int textureLoc = -1;
+    unsigned int vao = 0;
+    unsigned int cornerVbo = 0;
+    unsigned int rectVbo = 0;
+    unsigned int colorVbo = 0;
+    unsigned int uvVbo = 0;
+};
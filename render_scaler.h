@@ -0,0 +1,155 @@
+#pragma once
+
+#include "raylib.h"
+#include <algorithm>
+#include <cmath>
+
+// Draws the world into an offscreen target smaller than the window, then
+// stretches it over the window, trading sharpness for fill rate on large
+// panels with weak GPUs.
+//
+// The scale is a fraction of the window size per axis. With dynamic
+// resolution on, the scale actually used drops below the configured one when
+// frames miss their deadline while the CPU side of the frame fits, and climbs
+// back in small steps once frames have been on time for a while. The target
+// is allocated at the configured scale and a smaller scale only renders into
+// its top-left corner, so dynamic changes never reallocate it.
+//
+// raylib has no GPU timer queries, so "GPU-bound" is inferred: a frame that
+// takes longer than its budget although everything before EndDrawing() was
+// well inside it spent the difference waiting on the swap.
+//
+// Main thread only; Begin() and End() go between BeginDrawing() and EndDrawing().
+class RenderScaler {
+public:
+    static constexpr float MIN_SCALE = 0.5f;
+    static constexpr float MAX_SCALE = 1.0f;
+    static constexpr int WINDOW_FRAMES = 30;       // Frames averaged per dynamic decision
+    static constexpr float DROP_STEP = 0.1f;
+    static constexpr float RAISE_STEP = 0.05f;
+    static constexpr int RAISE_AFTER_WINDOWS = 4;  // On-time windows before trying a higher scale
+    static constexpr int MAX_RAISE_BACKOFF = 32;   // Windows to wait after repeated failed raises
+
+    // The configured scale; with dynamic resolution on it is the upper bound
+    void SetScale(float value) {
+        scale = std::clamp(value, MIN_SCALE, MAX_SCALE);
+        current = dynamic ? std::min(current, scale) : scale;
+    }
+
+    void SetDynamic(bool enabled) {
+        dynamic = enabled;
+        current = scale;
+        ResetDynamicState();
+    }
+
+    bool IsDynamic() const { return dynamic; }
+
+    // The configured scale, which render targets are sized for
+    float GetScale() const { return scale; }
+
+    // The scale the last Begin() rendered at
+    float GetCurrentScale() const { return current; }
+
+    // Offscreen only when it can make a difference; otherwise Begin/End cost nothing
+    bool IsActive() const { return dynamic || scale < MAX_SCALE; }
+
+    // Feed once per frame with the previous frame's total time, its time
+    // before EndDrawing(), and the frame budget. budget <= 0 disables the
+    // adjustment (uncapped frame rate has no deadline to miss).
+    void UpdateDynamic(double frameSeconds, double cpuSeconds, double budgetSeconds) {
+        if (!dynamic || budgetSeconds <= 0.0) return;
+        frameSum += frameSeconds;
+        cpuSum += cpuSeconds;
+        if (++frames < WINDOW_FRAMES) return;
+
+        double avgFrame = frameSum / frames;
+        double avgCpu = cpuSum / frames;
+        frameSum = cpuSum = 0.0;
+        frames = 0;
+
+        bool late = avgFrame > budgetSeconds * 1.1;
+        bool gpuBound = late && avgCpu < budgetSeconds * 0.75;
+        if (gpuBound && current > MIN_SCALE) {
+            if (raisedLastWindow) {
+                // The last raise did not hold: undo just that, and wait longer before the next try
+                current = std::max(MIN_SCALE, current - RAISE_STEP);
+                raiseBackoff = std::min(raiseBackoff * 2, MAX_RAISE_BACKOFF);
+            } else {
+                current = std::max(MIN_SCALE, current - DROP_STEP);
+            }
+            onTimeWindows = 0;
+        } else if (!late) {
+            if (raisedLastWindow) raiseBackoff = RAISE_AFTER_WINDOWS;
+            if (current < scale && ++onTimeWindows >= raiseBackoff) {
+                current = std::min(scale, current + RAISE_STEP);
+                onTimeWindows = 0;
+                raisedLastWindow = true;
+                return;
+            }
+        }
+        raisedLastWindow = false;
+    }
+
+    // Redirects drawing into the target; call with the window size
+    void Begin(int windowWidth, int windowHeight, Color background) {
+        if (!IsActive()) return;
+        EnsureTarget(windowWidth, windowHeight);
+        BeginTextureMode(target);
+        ClearBackground(background);
+        Camera2D camera = {};
+        camera.zoom = current; // Window coordinates in, scaled pixels out
+        BeginMode2D(camera);
+        drawWidth = std::max(1, (int)roundf(windowWidth * current));
+        drawHeight = std::max(1, (int)roundf(windowHeight * current));
+        drawing = true;
+    }
+
+    // Stretches what was drawn since Begin() over the window
+    void End(int windowWidth, int windowHeight) {
+        if (!drawing) return;
+        drawing = false;
+        EndMode2D();
+        EndTextureMode();
+        // Render textures are stored bottom-up: the top-left region starts at the far end, read with a negative height
+        Rectangle source = {0.0f, (float)(target.texture.height - drawHeight), (float)drawWidth, -(float)drawHeight};
+        DrawTexturePro(target.texture, source, {0.0f, 0.0f, (float)windowWidth, (float)windowHeight}, {0.0f, 0.0f}, 0.0f, WHITE);
+    }
+
+    // Frees the target; call before the window closes
+    void Unload() {
+        if (target.id != 0) UnloadRenderTexture(target);
+        target = RenderTexture2D{};
+    }
+
+private:
+    void EnsureTarget(int windowWidth, int windowHeight) {
+        int width = std::max(1, (int)roundf(windowWidth * scale));
+        int height = std::max(1, (int)roundf(windowHeight * scale));
+        if (target.id != 0 && target.texture.width == width && target.texture.height == height) return;
+        Unload();
+        target = LoadRenderTexture(width, height);
+        SetTextureFilter(target.texture, TEXTURE_FILTER_BILINEAR);
+    }
+
+    void ResetDynamicState() {
+        frameSum = cpuSum = 0.0;
+        frames = 0;
+        onTimeWindows = 0;
+        raiseBackoff = RAISE_AFTER_WINDOWS;
+        raisedLastWindow = false;
+    }
+
+    RenderTexture2D target = {};
+    float scale = MAX_SCALE;   // Configured
+    float current = MAX_SCALE; // In use; below scale only while dynamic resolution has dropped it
+    bool dynamic = false;
+    bool drawing = false;
+    int drawWidth = 0, drawHeight = 0;
+
+    double frameSum = 0.0;
+    double cpuSum = 0.0;
+    int frames = 0;
+    int onTimeWindows = 0;
+    int raiseBackoff = RAISE_AFTER_WINDOWS;
+    bool raisedLastWindow = false;
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "raylib.h"
+
+// Input modes
+enum class InputMode {
+    KEYBOARD_MOUSE,
+    CONTROLLER
+};
+
+// Save data structure
+struct SaveData {
+    Vector2 playerPos; // This will now store relative coordinates (0.0-1.0)
+    bool isFullscreen;
+    int targetFPS;
+    InputMode inputMode;
+    float volume; // 0.0 to 1.0
+    int simTickRate; // Simulation ticks per second, 0 = tie simulation to the frame rate
+    bool idlePacing; // Drop to a low frame rate while menus are static
+    int workerThreads; // Job system threads besides the main thread, 0 = one per extra core
+    bool exclusiveFullscreen; // Fullscreen changes the monitor's video mode instead of using a borderless window
+    float renderScale; // World render resolution as a fraction of the window, 0.5 to 1.0
+    bool dynamicResolution; // Lower renderScale automatically while the GPU misses the frame budget
+    bool lowLatency; // Sample input as late as the frame budget allows instead of at the top of the frame
+    bool frameQueueLimit; // Wait for the GPU after every swap so no frames queue up in the driver
+    bool splitScreen; // Give every player their own view of the world instead of sharing the window
+    
+    SaveData() : playerPos{0.1f, 0.1f}, isFullscreen(true), targetFPS(120), inputMode(InputMode::KEYBOARD_MOUSE), volume(0.5f), simTickRate(60), idlePacing(true), workerThreads(0), exclusiveFullscreen(false), renderScale(1.0f), dynamicResolution(false), lowLatency(false), frameQueueLimit(false), splitScreen(false) {}
+};
@@ -0,0 +1,283 @@
+#pragma once
+
+#include "save_data.h"
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>    // For open
+#include <sys/stat.h> // For fstat
+#include <unistd.h>   // For read
+
+// On-disk save format (all integers little-endian):
+//
+//   Header, 16 bytes
+//     char[4]  magic        "RTSV"
+//     uint16   version      SAVE_FORMAT_VERSION; bumped only if the header or
+//                           field encoding changes incompatibly
+//     uint16   headerSize   16; readers skip anything past the fields they know
+//     uint32   payloadSize  bytes of field data after the header
+//     uint32   checksum     CRC-32 of the payload
+//
+//   Payload: tagged fields, each
+//     uint16   tag          SaveField
+//     uint16   length       bytes of value that follow
+//     byte[]   value
+//
+// New data goes in new tags. Older builds skip tags they don't know and keep
+// defaults for tags that are missing, so adding player state needs no
+// migration. A bad magic, version or checksum loads defaults.
+
+constexpr char SAVE_FORMAT_MAGIC[4] = {'R', 'T', 'S', 'V'};
+constexpr uint16_t SAVE_FORMAT_VERSION = 1;
+constexpr uint16_t SAVE_HEADER_SIZE = 16;
+constexpr size_t SAVE_MAX_FILE_SIZE = 64 * 1024; // Anything bigger is not one of ours
+
+// Field tags; never renumber or reuse one
+enum class SaveField : uint16_t {
+    PLAYER_POS = 1,           // float x, float y (relative 0.0-1.0)
+    FULLSCREEN = 2,           // uint8
+    TARGET_FPS = 3,           // int32
+    INPUT_MODE = 4,           // uint8
+    VOLUME = 5,               // float
+    SIM_TICK_RATE = 6,        // int32
+    IDLE_PACING = 7,          // uint8
+    WORKER_THREADS = 8,       // int32
+    EXCLUSIVE_FULLSCREEN = 9, // uint8
+    RENDER_SCALE = 10,        // float
+    DYNAMIC_RESOLUTION = 11,  // uint8
+    LOW_LATENCY = 12,         // uint8
+    FRAME_QUEUE_LIMIT = 13,   // uint8
+    SPLIT_SCREEN = 14,        // uint8
+};
+
+inline uint32_t SaveChecksum(const uint8_t* data, size_t size) {
+    // CRC-32 (IEEE), table built on first use
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; i++) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+namespace save_format_detail {
+
+inline void PutU16(std::vector<uint8_t>& out, uint16_t v) {
+    out.push_back(v & 0xFF);
+    out.push_back(v >> 8);
+}
+
+inline void PutU32(std::vector<uint8_t>& out, uint32_t v) {
+    for (int i = 0; i < 4; i++) out.push_back((v >> (8 * i)) & 0xFF);
+}
+
+inline void PutF32(std::vector<uint8_t>& out, float v) {
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    PutU32(out, bits);
+}
+
+inline void SetU16(uint8_t* p, uint16_t v) {
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+
+inline void SetU32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (v >> (8 * i)) & 0xFF;
+}
+
+inline uint16_t GetU16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+
+inline uint32_t GetU32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+inline float GetF32(const uint8_t* p) {
+    uint32_t bits = GetU32(p);
+    float v;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+inline void BeginField(std::vector<uint8_t>& out, SaveField tag, uint16_t length) {
+    PutU16(out, (uint16_t)tag);
+    PutU16(out, length);
+}
+
+} // namespace save_format_detail
+
+// Serializes into out, reusing its capacity
+inline void EncodeSaveData(const SaveData& data, std::vector<uint8_t>& out) {
+    using namespace save_format_detail;
+    out.clear();
+    out.resize(SAVE_HEADER_SIZE); // Header is filled in once the payload size is known
+
+    BeginField(out, SaveField::PLAYER_POS, 8);
+    PutF32(out, data.playerPos.x);
+    PutF32(out, data.playerPos.y);
+    BeginField(out, SaveField::FULLSCREEN, 1);
+    out.push_back(data.isFullscreen ? 1 : 0);
+    BeginField(out, SaveField::TARGET_FPS, 4);
+    PutU32(out, (uint32_t)data.targetFPS);
+    BeginField(out, SaveField::INPUT_MODE, 1);
+    out.push_back((uint8_t)data.inputMode);
+    BeginField(out, SaveField::VOLUME, 4);
+    PutF32(out, data.volume);
+    BeginField(out, SaveField::SIM_TICK_RATE, 4);
+    PutU32(out, (uint32_t)data.simTickRate);
+    BeginField(out, SaveField::IDLE_PACING, 1);
+    out.push_back(data.idlePacing ? 1 : 0);
+    BeginField(out, SaveField::WORKER_THREADS, 4);
+    PutU32(out, (uint32_t)data.workerThreads);
+    BeginField(out, SaveField::EXCLUSIVE_FULLSCREEN, 1);
+    out.push_back(data.exclusiveFullscreen ? 1 : 0);
+    BeginField(out, SaveField::RENDER_SCALE, 4);
+    PutF32(out, data.renderScale);
+    BeginField(out, SaveField::DYNAMIC_RESOLUTION, 1);
+    out.push_back(data.dynamicResolution ? 1 : 0);
+    BeginField(out, SaveField::LOW_LATENCY, 1);
+    out.push_back(data.lowLatency ? 1 : 0);
+    BeginField(out, SaveField::FRAME_QUEUE_LIMIT, 1);
+    out.push_back(data.frameQueueLimit ? 1 : 0);
+    BeginField(out, SaveField::SPLIT_SCREEN, 1);
+    out.push_back(data.splitScreen ? 1 : 0);
+
+    uint32_t payloadSize = (uint32_t)(out.size() - SAVE_HEADER_SIZE);
+    uint8_t* header = out.data();
+    memcpy(header, SAVE_FORMAT_MAGIC, 4);
+    SetU16(header + 4, SAVE_FORMAT_VERSION);
+    SetU16(header + 6, SAVE_HEADER_SIZE);
+    SetU32(header + 8, payloadSize);
+    SetU32(header + 12, SaveChecksum(header + SAVE_HEADER_SIZE, payloadSize));
+}
+
+// Parses a whole save file held in memory. Returns false (leaving out
+// untouched) if the header or checksum is bad. Known fields with a wrong
+// length or an out-of-range value keep their defaults.
+inline bool DecodeSaveData(const uint8_t* bytes, size_t size, SaveData& out) {
+    using namespace save_format_detail;
+    if (size < SAVE_HEADER_SIZE || memcmp(bytes, SAVE_FORMAT_MAGIC, 4) != 0) return false;
+
+    uint16_t version = GetU16(bytes + 4);
+    uint16_t headerSize = GetU16(bytes + 6);
+    uint32_t payloadSize = GetU32(bytes + 8);
+    uint32_t checksum = GetU32(bytes + 12);
+    if (version != SAVE_FORMAT_VERSION || headerSize < SAVE_HEADER_SIZE) return false;
+    if ((size_t)headerSize + payloadSize > size) return false;
+
+    const uint8_t* payload = bytes + headerSize;
+    if (SaveChecksum(payload, payloadSize) != checksum) return false;
+
+    SaveData result; // Starts from defaults
+    size_t offset = 0;
+    while (offset + 4 <= payloadSize) {
+        SaveField tag = (SaveField)GetU16(payload + offset);
+        uint16_t length = GetU16(payload + offset + 2);
+        offset += 4;
+        if (offset + length > payloadSize) return false;
+        const uint8_t* value = payload + offset;
+        offset += length;
+
+        switch (tag) {
+            case SaveField::PLAYER_POS:
+                if (length == 8) {
+                    float x = GetF32(value);
+                    float y = GetF32(value + 4);
+                    if (x >= 0.0f && x <= 1.0f && y >= 0.0f && y <= 1.0f) result.playerPos = {x, y};
+                }
+                break;
+            case SaveField::FULLSCREEN:
+                if (length == 1 && value[0] <= 1) result.isFullscreen = value[0] == 1;
+                break;
+            case SaveField::TARGET_FPS:
+                if (length == 4) {
+                    int fps = (int)GetU32(value);
+                    if (fps >= 15 && fps <= 1000) result.targetFPS = fps;
+                }
+                break;
+            case SaveField::INPUT_MODE:
+                if (length == 1 && value[0] <= (uint8_t)InputMode::CONTROLLER) result.inputMode = (InputMode)value[0];
+                break;
+            case SaveField::VOLUME:
+                if (length == 4) {
+                    float volume = GetF32(value);
+                    if (volume >= 0.0f && volume <= 1.0f) result.volume = volume;
+                }
+                break;
+            case SaveField::SIM_TICK_RATE:
+                if (length == 4) {
+                    int rate = (int)GetU32(value);
+                    if (rate >= 0 && rate <= 1000) result.simTickRate = rate;
+                }
+                break;
+            case SaveField::IDLE_PACING:
+                if (length == 1 && value[0] <= 1) result.idlePacing = value[0] == 1;
+                break;
+            case SaveField::WORKER_THREADS:
+                if (length == 4) {
+                    int threads = (int)GetU32(value);
+                    if (threads >= 0 && threads <= 64) result.workerThreads = threads;
+                }
+                break;
+            case SaveField::EXCLUSIVE_FULLSCREEN:
+                if (length == 1 && value[0] <= 1) result.exclusiveFullscreen = value[0] == 1;
+                break;
+            case SaveField::RENDER_SCALE:
+                if (length == 4) {
+                    float scale = GetF32(value);
+                    if (scale >= 0.5f && scale <= 1.0f) result.renderScale = scale;
+                }
+                break;
+            case SaveField::DYNAMIC_RESOLUTION:
+                if (length == 1 && value[0] <= 1) result.dynamicResolution = value[0] == 1;
+                break;
+            case SaveField::LOW_LATENCY:
+                if (length == 1 && value[0] <= 1) result.lowLatency = value[0] == 1;
+                break;
+            case SaveField::FRAME_QUEUE_LIMIT:
+                if (length == 1 && value[0] <= 1) result.frameQueueLimit = value[0] == 1;
+                break;
+            case SaveField::SPLIT_SCREEN:
+                if (length == 1 && value[0] <= 1) result.splitScreen = value[0] == 1;
+                break;
+            default:
+                break; // Written by a newer build; skip it
+        }
+    }
+
+    out = result;
+    return true;
+}
+
+enum class SaveLoadResult {
+    LOADED,
+    MISSING,
+    CORRUPT
+};
+
+// Reads the whole file with one read() and decodes it from memory
+inline SaveLoadResult LoadSaveFile(const std::string& path, SaveData& out) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return SaveLoadResult::MISSING;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0 || (size_t)info.st_size > SAVE_MAX_FILE_SIZE) {
+        close(fd);
+        return SaveLoadResult::CORRUPT;
+    }
+
+    std::vector<uint8_t> bytes((size_t)info.st_size);
+    ssize_t bytesRead = read(fd, bytes.data(), bytes.size());
+    close(fd);
+    if (bytesRead != (ssize_t)bytes.size()) return SaveLoadResult::CORRUPT;
+
+    return DecodeSaveData(bytes.data(), bytes.size(), out) ? SaveLoadResult::LOADED : SaveLoadResult::CORRUPT;
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "profiler.h"
+#include "save_format.h"
+#include "trace_export.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cerrno>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <fcntl.h>  // For open
+#include <unistd.h> // For write, fsync
+
+// Writes SaveData on a background thread so the frame thread never touches
+// the disk.
+//
+// The frame thread copies a snapshot into the pending half of a double
+// buffer and returns. The worker waits a short coalescing window so bursts of
+// saves (holding the volume button, say) become one write, then writes the
+// latest snapshot to a temp file, fsyncs it, renames it over the save file and
+// fsyncs the directory. A crash mid-write therefore leaves the previous save intact.
+class SaveWriter {
+public:
+    static constexpr std::chrono::milliseconds COALESCE_WINDOW{250};
+
+    ~SaveWriter() { Stop(); }
+
+    // Records each file write as a trace event; set before Start()
+    void SetTrace(TraceRecorder* recorder) { trace = recorder; }
+
+    void Start(const std::string& path) {
+        if (worker.joinable()) return;
+        filePath = path;
+        stopRequested = false;
+        worker = std::thread(&SaveWriter::WorkerMain, this);
+    }
+
+    // Writes anything still pending immediately, then joins the worker
+    void Stop() {
+        if (!worker.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopRequested = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+
+    // Frame thread: queue a snapshot, replacing any not yet written
+    void Submit(const SaveData& data) {
+        PROFILE_ALLOC_TAG(AllocTag::SAVE);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            buffers[pendingIndex] = data;
+            hasPending = true;
+            lastSubmit = std::chrono::steady_clock::now();
+        }
+        wake.notify_one();
+    }
+
+    // Frame thread: true once per finished write, with its outcome
+    bool PollCompleted(bool& success) {
+        int finished = completedWrites.load(std::memory_order_acquire);
+        if (finished == reportedWrites) return false;
+        reportedWrites = finished;
+        success = lastWriteOk.load(std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    void WorkerMain() {
+        PROFILE_ALLOC_TAG(AllocTag::SAVE);
+        if (trace) trace->SetThreadName("save");
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [this] { return stopRequested || hasPending; });
+            if (!hasPending) break; // Stop requested with nothing left to write
+
+            // Let closely spaced saves merge; each new Submit pushes the deadline out
+            while (!stopRequested) {
+                auto deadline = lastSubmit + COALESCE_WINDOW;
+                if (wake.wait_until(lock, deadline, [this] { return stopRequested; })) break;
+                if (std::chrono::steady_clock::now() >= lastSubmit + COALESCE_WINDOW) break;
+            }
+
+            // Flip the buffers so Submit can keep writing while this one is on disk
+            int writeIndex = pendingIndex;
+            pendingIndex = 1 - pendingIndex;
+            hasPending = false;
+            lock.unlock();
+
+            auto writeStart = std::chrono::steady_clock::now();
+            bool ok = WriteFileAtomically(buffers[writeIndex]);
+            if (trace) trace->Complete("Write save file", "io", writeStart, std::chrono::steady_clock::now());
+            lastWriteOk.store(ok, std::memory_order_relaxed);
+            completedWrites.fetch_add(1, std::memory_order_release);
+
+            lock.lock();
+        }
+    }
+
+    bool WriteFileAtomically(const SaveData& data) {
+        EncodeSaveData(data, encoded);
+        std::string tempPath = filePath + ".tmp";
+        const uint8_t* bytes = encoded.data();
+        size_t remaining = encoded.size();
+
+        int fd = open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+        while (remaining > 0) {
+            ssize_t written = write(fd, bytes, remaining);
+            if (written < 0 && errno == EINTR) continue; // Interrupted before writing anything
+            if (written <= 0) {
+                close(fd);
+                unlink(tempPath.c_str());
+                return false;
+            }
+            bytes += written;
+            remaining -= written;
+        }
+        // Data must be on disk before the rename makes it the live save
+        bool synced = fsync(fd) == 0;
+        close(fd);
+        if (!synced || std::rename(tempPath.c_str(), filePath.c_str()) != 0) {
+            unlink(tempPath.c_str());
+            return false;
+        }
+        return SyncParentDirectory();
+    }
+
+    // The rename is only durable once the directory entry is on disk too
+    bool SyncParentDirectory() const {
+        size_t slash = filePath.find_last_of('/');
+        std::string directory = slash == std::string::npos ? "." : filePath.substr(0, std::max<size_t>(slash, 1));
+        int fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+        if (fd < 0) return false;
+        bool synced = fsync(fd) == 0;
+        close(fd);
+        return synced;
+    }
+
+    std::string filePath;
+    TraceRecorder* trace = nullptr;
+    std::vector<uint8_t> encoded; // Worker only, reused between writes
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+
+    // Guarded by mutex
+    SaveData buffers[2];
+    int pendingIndex = 0;
+    bool hasPending = false;
+    bool stopRequested = false;
+    std::chrono::steady_clock::time_point lastSubmit;
+
+    std::atomic<int> completedWrites{0};
+    std::atomic<bool> lastWriteOk{false};
+    int reportedWrites = 0; // Frame thread only
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// How a screen behaves when it is, or sits under, the top of the stack
+enum ScreenFlag : uint8_t {
+    SCREEN_TRANSPARENT = 1 << 0,    // The screens below it stay visible
+    SCREEN_UPDATE_COVERED = 1 << 1, // Keeps updating under other screens; otherwise it is frozen
+    SCREEN_DRAW_COVERED = 1 << 2,   // Redrawn every frame while visible under a transparent
+                                    // screen; otherwise its last frame is reused from a snapshot
+};
+
+// Stack of UI screens: the top one takes input, and drawing starts at the
+// lowest screen that still shows through the transparent ones above it.
+// Screens hidden under an opaque one are neither drawn nor (without
+// SCREEN_UPDATE_COVERED) updated, so a deep stack costs no more than its top.
+//
+// Ids are whatever enum the caller uses. Every push gets a new serial, so a
+// cache built from the screens up to some layer stays valid exactly as long
+// as that layer's serial is unchanged: nothing below it can change without
+// popping it first.
+template <typename Id, int MAX_DEPTH = 8>
+class ScreenStack {
+public:
+    struct Layer {
+        Id id;
+        uint8_t flags;
+        uint32_t serial;
+
+        bool Has(ScreenFlag flag) const { return (flags & flag) != 0; }
+    };
+
+    // Drops every screen and starts over with one
+    void Reset(Id id, uint8_t flags) {
+        depth = 0;
+        Push(id, flags);
+    }
+
+    // False when the stack is full
+    bool Push(Id id, uint8_t flags) {
+        if (depth == MAX_DEPTH) return false;
+        layers[depth++] = {id, flags, ++nextSerial};
+        version++;
+        return true;
+    }
+
+    // The bottom screen stays; everything goes back to some screen
+    void Pop() {
+        if (depth <= 1) return;
+        depth--;
+        version++;
+    }
+
+    int Size() const { return depth; }
+    bool IsEmpty() const { return depth == 0; }
+    const Layer& operator[](int index) const { return layers[index]; }
+    const Layer& Top() const { return layers[depth - 1]; }
+
+    bool Contains(Id id) const {
+        for (int i = 0; i < depth; i++) {
+            if (layers[i].id == id) return true;
+        }
+        return false;
+    }
+
+    // Changes on every push and pop
+    uint32_t GetVersion() const { return version; }
+
+    // Index of the lowest screen that shows: the first opaque one from the top down
+    int GetFirstVisible() const {
+        int index = depth - 1;
+        while (index > 0 && layers[index].Has(SCREEN_TRANSPARENT)) index--;
+        return index;
+    }
+
+private:
+    std::array<Layer, MAX_DEPTH> layers{};
+    int depth = 0;
+    uint32_t nextSerial = 0;
+    uint32_t version = 0;
+};
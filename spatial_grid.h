@@ -0,0 +1,197 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Loose uniform grid over an unbounded plane, stored as a spatial hash.
+//
+// Objects are axis-aligned boxes identified by a caller-chosen id (a small
+// integer such as an entity slot or menu item index). Each box is filed under
+// the one cell holding its top-left corner, and queries widen their search by
+// the largest box seen so far, so a box never has to be listed in several
+// cells. Cells hash into a fixed number of buckets, so memory stays
+// proportional to the object count however far apart objects are.
+//
+// Update() only touches the buckets when a box's corner moves into another
+// cell, and then in constant time, so keeping the grid in step with moving
+// objects costs little more than storing the new bounds. Bucket vectors keep
+// their capacity, so once they have grown to fit the scene, updates and queries
+// do not allocate.
+//
+// Queries take a callback, report each matching id exactly once and test the
+// real bounds, so hash collisions never show up as false hits. Boxes are
+// half-open: [x, x + width) x [y, y + height). Pick a cell size around the
+// size of a typical box; a few boxes much larger than the rest only make
+// queries scan a wider ring of cells.
+class SpatialGrid {
+public:
+    static constexpr uint32_t INITIAL_BUCKET_CAPACITY = 8;
+
+    explicit SpatialGrid(float cellSize = 64.0f, uint32_t expectedObjects = 0) {
+        Reset(cellSize, expectedObjects);
+    }
+
+    // Removes everything and picks a new cell size; bucket count grows with expectedObjects
+    void Reset(float newCellSize, uint32_t expectedObjects = 0) {
+        cellSize = newCellSize > 0.0f ? newCellSize : 1.0f;
+        inverseCellSize = 1.0f / cellSize;
+        uint32_t bucketCount = 64;
+        while (bucketCount < expectedObjects && bucketCount < (1u << 24)) bucketCount <<= 1;
+        for (auto& bucket : buckets) bucket.clear();
+        buckets.resize(bucketCount);
+        // Room for a few objects per bucket up front, so objects wandering into new
+        // cells don't allocate on every first visit
+        for (auto& bucket : buckets) bucket.reserve(INITIAL_BUCKET_CAPACITY);
+        bucketMask = bucketCount - 1;
+        for (Record& record : records) record.active = false;
+        count = 0;
+        maxExtent = 0.0f;
+    }
+
+    void Clear() { Reset(cellSize, (uint32_t)buckets.size()); }
+
+    float GetCellSize() const { return cellSize; }
+    uint32_t Count() const { return count; }
+    bool Contains(uint32_t id) const { return id < records.size() && records[id].active; }
+
+    // Adds id, or moves it if it is already in the grid
+    void Insert(uint32_t id, float x, float y, float width, float height) {
+        if (Contains(id)) {
+            Update(id, x, y, width, height);
+            return;
+        }
+        if (id >= records.size()) records.resize(id + 1);
+        Record& record = records[id];
+        record.active = true;
+        SetBounds(record, x, y, width, height);
+        AddToCell(id, record, CellOf(x), CellOf(y));
+        count++;
+    }
+
+    // New bounds for an object already in the grid; re-files it only when its corner changed cell
+    void Update(uint32_t id, float x, float y, float width, float height) {
+        if (!Contains(id)) {
+            Insert(id, x, y, width, height);
+            return;
+        }
+        Record& record = records[id];
+        SetBounds(record, x, y, width, height);
+        int32_t cx = CellOf(x);
+        int32_t cy = CellOf(y);
+        if (cx == record.cx && cy == record.cy) return;
+        RemoveFromCell(record);
+        AddToCell(id, record, cx, cy);
+    }
+
+    // Does nothing for ids that are not in the grid
+    void Remove(uint32_t id) {
+        if (!Contains(id)) return;
+        RemoveFromCell(records[id]);
+        records[id].active = false;
+        count--;
+    }
+
+    // Calls fn(id) for every object containing the point
+    template <typename Fn>
+    void QueryPoint(float x, float y, Fn&& fn) const {
+        ForEachCandidate(x, y, x, y, [&](uint32_t id, const Record& r) {
+            if (x >= r.minX && x < r.maxX && y >= r.minY && y < r.maxY) fn(id);
+        });
+    }
+
+    // Calls fn(id) for every object overlapping the box
+    template <typename Fn>
+    void QueryRect(float x, float y, float width, float height, Fn&& fn) const {
+        float maxX = x + width;
+        float maxY = y + height;
+        ForEachCandidate(x, y, maxX, maxY, [&](uint32_t id, const Record& r) {
+            if (r.minX < maxX && x < r.maxX && r.minY < maxY && y < r.maxY) fn(id);
+        });
+    }
+
+    // Calls fn(a, b) once for every pair of overlapping objects, with a < b
+    template <typename Fn>
+    void QueryPairs(Fn&& fn) const {
+        for (uint32_t a = 0; a < (uint32_t)records.size(); a++) {
+            const Record& ra = records[a];
+            if (!ra.active) continue;
+            ForEachCandidate(ra.minX, ra.minY, ra.maxX, ra.maxY, [&](uint32_t b, const Record& rb) {
+                if (b <= a) return;
+                if (rb.minX < ra.maxX && ra.minX < rb.maxX && rb.minY < ra.maxY && ra.minY < rb.maxY) fn(a, b);
+            });
+        }
+    }
+
+private:
+    struct Entry {
+        uint32_t id;
+        int32_t cx, cy; // Cell this entry is filed under; several cells can share a bucket
+    };
+
+    struct Record {
+        float minX = 0, minY = 0, maxX = 0, maxY = 0;
+        int32_t cx = 0, cy = 0; // Cell holding the top-left corner
+        uint32_t position = 0;  // Index in that cell's bucket
+        bool active = false;
+    };
+
+    // floor() without the libm call; truncation rounds negative cells the wrong way
+    int32_t CellOf(float v) const {
+        float scaled = v * inverseCellSize;
+        int32_t cell = (int32_t)scaled;
+        return cell - (scaled < (float)cell);
+    }
+
+    uint32_t BucketOf(int32_t cx, int32_t cy) const {
+        return (((uint32_t)cx * 73856093u) ^ ((uint32_t)cy * 19349663u)) & bucketMask;
+    }
+
+    // Every object whose corner lies in a cell that a box reaching into [minX, maxX] x [minY, maxY] could start in
+    template <typename Fn>
+    void ForEachCandidate(float minX, float minY, float maxX, float maxY, Fn&& fn) const {
+        int32_t cx0 = CellOf(minX - maxExtent);
+        int32_t cy0 = CellOf(minY - maxExtent);
+        int32_t cx1 = CellOf(maxX);
+        int32_t cy1 = CellOf(maxY);
+        for (int32_t cy = cy0; cy <= cy1; cy++) {
+            for (int32_t cx = cx0; cx <= cx1; cx++) {
+                for (const Entry& entry : buckets[BucketOf(cx, cy)]) {
+                    if (entry.cx == cx && entry.cy == cy) fn(entry.id, records[entry.id]);
+                }
+            }
+        }
+    }
+
+    void SetBounds(Record& record, float x, float y, float width, float height) {
+        record.minX = x;
+        record.minY = y;
+        record.maxX = x + width;
+        record.maxY = y + height;
+        maxExtent = std::max(maxExtent, std::max(width, height));
+    }
+
+    void AddToCell(uint32_t id, Record& record, int32_t cx, int32_t cy) {
+        auto& bucket = buckets[BucketOf(cx, cy)];
+        record.cx = cx;
+        record.cy = cy;
+        record.position = (uint32_t)bucket.size();
+        bucket.push_back({id, cx, cy});
+    }
+
+    // Swap-removes the record's entry, fixing up the entry moved into its place
+    void RemoveFromCell(const Record& record) {
+        auto& bucket = buckets[BucketOf(record.cx, record.cy)];
+        bucket[record.position] = bucket.back();
+        records[bucket[record.position].id].position = record.position;
+        bucket.pop_back();
+    }
+
+    float cellSize = 64.0f;
+    float inverseCellSize = 1.0f / 64.0f;
+    float maxExtent = 0.0f; // Largest width or height since the last Reset()
+    std::vector<std::vector<Entry>> buckets;
+    uint32_t bucketMask = 0;
+    std::vector<Record> records; // Indexed by id
+    uint32_t count = 0;
+};
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "raylib.h"
+#include "quad_batch.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+// Split-screen views: the window is divided between up to MAX_VIEWS players,
+// each view drawn into its own render texture by a camera that follows its
+// player, then all of them composited onto the window in one quad batch
+// flush.
+//
+// The world is built into the quad batch once per frame and that same batch
+// is submitted into every view (QuadBatch::Submit() keeps its quads), so a
+// second player costs one more draw of the batch rather than another pass
+// over the entities.
+//
+// Views work at the render scaler's scales: targets are allocated at the
+// configured scale and a lower dynamic scale only renders into their
+// top-left corner, as RenderScaler does, so targets are only recreated when
+// the layout or window size changes.
+//
+// Main thread only; everything goes between BeginDrawing() and EndDrawing().
+class SplitScreen {
+public:
+    static constexpr int MAX_VIEWS = 4;
+
+    // Two views side by side; three or four in a 2x2 grid (the fourth cell stays empty for three)
+    static Rectangle GetViewport(int index, int count, int windowWidth, int windowHeight) {
+        int columns = count > 1 ? 2 : 1;
+        int rows = count > 2 ? 2 : 1;
+        float width = (float)windowWidth / columns;
+        float height = (float)windowHeight / rows;
+        return {(index % columns) * width, (index / columns) * height, width, height};
+    }
+
+    // Starts a frame with count views; scale is the configured render scale and current the one in use
+    void Begin(int count, int windowWidth, int windowHeight, float scale, float current) {
+        viewCount = std::clamp(count, 1, MAX_VIEWS);
+        renderScale = current;
+        for (int i = 0; i < viewCount; i++) {
+            View& view = views[i];
+            view.viewport = GetViewport(i, viewCount, windowWidth, windowHeight);
+            EnsureTarget(view, scale);
+            view.drawWidth = std::max(1, (int)roundf(view.viewport.width * current));
+            view.drawHeight = std::max(1, (int)roundf(view.viewport.height * current));
+        }
+    }
+
+    int GetViewCount() const { return viewCount; }
+    Rectangle GetViewport(int index) const { return views[index].viewport; }
+
+    // Redirects drawing into view index, centred on focus (in window coordinates,
+    // like the world) but never showing past the edges of a worldWidth x worldHeight world
+    void BeginView(int index, Vector2 focus, float worldWidth, float worldHeight, Color background) {
+        View& view = views[index];
+        BeginTextureMode(view.target);
+        ClearBackground(background);
+        float halfWidth = view.viewport.width / 2.0f;
+        float halfHeight = view.viewport.height / 2.0f;
+        Camera2D camera = {};
+        camera.offset = {view.drawWidth / 2.0f, view.drawHeight / 2.0f};
+        camera.target = {std::clamp(focus.x, halfWidth, std::max(halfWidth, worldWidth - halfWidth)),
+                         std::clamp(focus.y, halfHeight, std::max(halfHeight, worldHeight - halfHeight))};
+        camera.zoom = renderScale;
+        BeginMode2D(camera);
+    }
+
+    void EndView() {
+        EndMode2D();
+        EndTextureMode();
+    }
+
+    // Adds every view to batch over its part of the window, with a divider between them
+    void Composite(QuadBatch& batch, int layer, Color divider) {
+        for (int i = 0; i < viewCount; i++) {
+            const View& view = views[i];
+            // Flipped: the view's top row is the texture's last one (see AddTextureRegion())
+            Rectangle source = {0.0f, (float)view.target.texture.height, (float)view.drawWidth, -(float)view.drawHeight};
+            batch.AddTextureRegion(view.target.texture, source, view.viewport, WHITE, layer);
+            batch.AddRectLines(view.viewport, 1.0f, divider, layer + 1);
+        }
+    }
+
+    // Frees the targets; call before the window closes
+    void Unload() {
+        for (View& view : views) {
+            if (view.target.id != 0) UnloadRenderTexture(view.target);
+            view.target = RenderTexture2D{};
+        }
+    }
+
+private:
+    struct View {
+        RenderTexture2D target = {};
+        Rectangle viewport = {};
+        int drawWidth = 0, drawHeight = 0;
+    };
+
+    static void EnsureTarget(View& view, float scale) {
+        int width = std::max(1, (int)roundf(view.viewport.width * scale));
+        int height = std::max(1, (int)roundf(view.viewport.height * scale));
+        if (view.target.id != 0 && view.target.texture.width == width && view.target.texture.height == height) return;
+        if (view.target.id != 0) UnloadRenderTexture(view.target);
+        view.target = LoadRenderTexture(width, height);
+        SetTextureFilter(view.target.texture, TEXTURE_FILTER_BILINEAR);
+    }
+
+    std::array<View, MAX_VIEWS> views{};
+    int viewCount = 1;
+    float renderScale = 1.0f;
+};
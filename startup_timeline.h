@@ -0,0 +1,82 @@
+#pragma once
+
+#include "trace_export.h"
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <utility>
+
+// Startup steps with their start/end times and the thread they ran on, printed
+// once the first frame is on screen, and forwarded to a trace recorder when one
+// is set. Steps come from several threads, so Record() takes a lock; it only
+// runs a handful of times during startup.
+class StartupTimeline {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr int MAX_STEPS = 24;
+
+    StartupTimeline() : origin(Clock::now()) {}
+
+    // Also sends every step to trace, on a track named after its thread label
+    void SetTrace(TraceRecorder* recorder) { trace = recorder; }
+
+    // Adds a step that ran on thread (a short label) from start to end
+    void Record(const char* name, const char* thread, Clock::time_point start, Clock::time_point end) {
+        if (trace) trace->Complete(name, "startup", start, end, thread);
+        std::lock_guard<std::mutex> lock(mutex);
+        if (count == MAX_STEPS) return;
+        steps[count++] = {name, thread, ToMs(start), ToMs(end)};
+    }
+
+    // Prints every step in start order, then the time to the first frame
+    void Print(Clock::time_point firstFrame) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int i = 1; i < count; i++) {
+            for (int j = i; j > 0 && steps[j].startMs < steps[j - 1].startMs; j--) std::swap(steps[j], steps[j - 1]);
+        }
+        printf("[STARTUP] %-8s %9s %9s %9s  %s\n", "thread", "start ms", "end ms", "took ms", "step");
+        for (int i = 0; i < count; i++) {
+            const Step& step = steps[i];
+            printf("[STARTUP] %-8s %9.1f %9.1f %9.1f  %s\n", step.thread, step.startMs, step.endMs,
+                   step.endMs - step.startMs, step.name);
+        }
+        printf("[STARTUP] First frame after %.1f ms\n", ToMs(firstFrame));
+    }
+
+private:
+    struct Step {
+        const char* name;
+        const char* thread;
+        double startMs;
+        double endMs;
+    };
+
+    double ToMs(Clock::time_point time) const {
+        return std::chrono::duration<double, std::milli>(time - origin).count();
+    }
+
+    Clock::time_point origin;
+    TraceRecorder* trace = nullptr;
+    std::mutex mutex;
+    std::array<Step, MAX_STEPS> steps;
+    int count = 0;
+};
+
+// Records the enclosing scope as one startup step
+class StartupStep {
+public:
+    StartupStep(StartupTimeline& timeline, const char* name, const char* thread = "main")
+        : timeline(timeline), name(name), thread(thread), start(StartupTimeline::Clock::now()) {}
+    ~StartupStep() { timeline.Record(name, thread, start, StartupTimeline::Clock::now()); }
+
+    StartupStep(const StartupStep&) = delete;
+    StartupStep& operator=(const StartupStep&) = delete;
+
+private:
+    StartupTimeline& timeline;
+    const char* name;
+    const char* thread;
+    StartupTimeline::Clock::time_point start;
+};
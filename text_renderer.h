@@ -0,0 +1,252 @@
+#pragma once
+
+#include "raylib.h"
+#include "asset_manager.h"
+#include "quad_batch.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// UI text drawn from pre-baked glyph atlases through the quad batch.
+//
+// DrawText() scales raylib's 10 px default font up to whatever size it is
+// given, so large windows get blurry, blocky letters, and every string is laid
+// out glyph by glyph each time it is drawn. Here the UI font is rasterized at
+// a ladder of sizes instead, each atlas baked once on the asset loader threads
+// the first time a size close to it is asked for (startup, and a resize that
+// moves the UI sizes to another step). Text is drawn from the smallest atlas
+// at least as large as requested, so glyphs are only ever scaled down, by at
+// most one step, with bilinear filtering.
+//
+// Laid-out strings are kept in a small direct-mapped cache: labels that stay
+// the same from frame to frame are shaped once and then cost one quad per
+// glyph appended to the batch, which draws all the text of a flush with one
+// call per atlas.
+//
+// Until an atlas is ready, the nearest ready one (or the default font) stands
+// in; GetVersion() changes when one becomes ready, so callers that cached
+// measurements know to measure again. Without the font file everything uses
+// raylib's default font, spaced the way DrawText() spaces it. Text is single
+// line and ASCII; other bytes draw as '?'. Main thread only.
+class TextRenderer {
+public:
+    static constexpr int LADDER_SIZES[] = {12, 16, 20, 24, 32, 40, 48, 64, 80, 96, 128};
+    static constexpr int ATLAS_COUNT = (int)(sizeof(LADDER_SIZES) / sizeof(LADDER_SIZES[0]));
+    static constexpr int CACHE_SLOTS = 128; // Power of two
+    static constexpr int SLOT_RESERVE = 64; // Characters per slot allocated up front, so the frame loop doesn't allocate when a label is re-laid out
+    static constexpr int DEFAULT_FONT_SIZE = 10; // raylib's built-in font
+
+    struct Stats {
+        int glyphs = 0;  // Quads added since the last ResetStats()
+        int shaped = 0;  // Strings laid out instead of found in the cache
+        int cached = 0;  // Strings found in the cache
+    };
+
+    // Call after the window is open; with no file at path the default font is used for everything
+    void Init(AssetManager& manager, const std::string& path) {
+        assets = &manager;
+        fontPath = path;
+        hasFontFile = FileExists(ResolveAssetPath(path).c_str());
+        for (Slot& slot : cache) {
+            slot.text.reserve(SLOT_RESERVE);
+            slot.dest.reserve(SLOT_RESERVE);
+            slot.source.reserve(SLOT_RESERVE);
+        }
+        if (!hasFontFile) {
+            printf("[INFO] UI font %s not found; text uses the default font\n", path.c_str());
+        }
+    }
+
+    // Releases the atlases; call before AssetManager::UnloadAll()
+    void Shutdown() {
+        if (assets) {
+            for (Atlas& atlas : atlases) {
+                if (!atlas.handle.IsNull()) assets->Release(atlas.handle);
+                atlas = Atlas();
+            }
+        }
+        assets = nullptr;
+        for (Slot& slot : cache) slot.valid = false;
+    }
+
+    // Once per frame, after AssetManager::Update(): picks up atlases that finished loading
+    void Update() {
+        if (!assets) return;
+        for (int i = 0; i < ATLAS_COUNT; i++) {
+            Atlas& atlas = atlases[i];
+            if (atlas.ready || atlas.failed || atlas.handle.IsNull()) continue;
+            AssetState state = assets->GetState(atlas.handle);
+            if (state == AssetState::LOADING) continue;
+            if (state == AssetState::READY) {
+                atlas.font = assets->GetFont(atlas.handle);
+                SetTextureFilter(atlas.font.texture, TEXTURE_FILTER_BILINEAR);
+                BuildLookup(atlas.font, atlas.lookup);
+                atlas.ready = true;
+            } else {
+                atlas.failed = true;
+            }
+            version++;
+        }
+    }
+
+    // Starts baking the atlas that text of this size will use, ahead of drawing it
+    void Prepare(float size) { Request(LadderIndex(size)); }
+
+    // Changes whenever an atlas becomes ready (or fails), which changes how text measures
+    uint32_t GetVersion() const { return version; }
+
+    // Width in pixels of text drawn at size
+    float Measure(const char* text, float size) { return Shape(text, size).width; }
+
+    // Appends one quad per visible glyph to batch, top-left at position; returns the width.
+    // The caller flushes the batch, so text can share a flush with the widgets under it.
+    float Draw(QuadBatch& batch, const char* text, Vector2 position, float size, Color color, int layer) {
+        const Slot& slot = Shape(text, size);
+        float x = roundf(position.x); // Whole pixels keep the glyph edges sharp
+        float y = roundf(position.y);
+        for (size_t i = 0; i < slot.dest.size(); i++) {
+            Rectangle dest = slot.dest[i];
+            dest.x += x;
+            dest.y += y;
+            batch.AddTextureRegion(slot.texture, slot.source[i], dest, color, layer);
+        }
+        stats.glyphs += (int)slot.dest.size();
+        return slot.width;
+    }
+
+    const Stats& GetStats() const { return stats; }
+    void ResetStats() { stats = Stats(); }
+
+private:
+    struct Atlas {
+        AssetHandle handle;
+        Font font = {};
+        std::array<int, 128> lookup{}; // ASCII to glyph index
+        bool ready = false;
+        bool failed = false;
+    };
+
+    // One laid-out string, positions relative to its top-left corner
+    struct Slot {
+        bool valid = false;
+        uint64_t hash = 0;
+        float size = 0.0f;
+        int atlas = -1; // -1 = default font
+        std::string text;
+        std::vector<Rectangle> dest;
+        std::vector<Rectangle> source;
+        Texture2D texture = {};
+        float width = 0.0f;
+    };
+
+    static int LadderIndex(float size) {
+        for (int i = 0; i < ATLAS_COUNT; i++) {
+            if (LADDER_SIZES[i] >= size) return i;
+        }
+        return ATLAS_COUNT - 1;
+    }
+
+    void Request(int index) {
+        if (!assets || !hasFontFile) return;
+        Atlas& atlas = atlases[index];
+        if (!atlas.handle.IsNull()) return;
+        atlas.handle = assets->RequestFont(fontPath, LADDER_SIZES[index]);
+    }
+
+    // The wanted atlas if ready, else the nearest ready one, preferring larger; -1 for the default font
+    int Resolve(float size) {
+        int wanted = LadderIndex(size);
+        Request(wanted);
+        for (int distance = 0; distance < ATLAS_COUNT; distance++) {
+            if (wanted + distance < ATLAS_COUNT && atlases[wanted + distance].ready) return wanted + distance;
+            if (wanted - distance >= 0 && atlases[wanted - distance].ready) return wanted - distance;
+        }
+        return -1;
+    }
+
+    static void BuildLookup(const Font& font, std::array<int, 128>& lookup) {
+        int fallback = GetGlyphIndex(font, '?');
+        for (int c = 0; c < 128; c++) lookup[c] = c >= 32 ? GetGlyphIndex(font, c) : fallback;
+    }
+
+    static uint64_t Hash(const char* text, size_t& length) {
+        uint64_t hash = 14695981039346656037ull; // FNV-1a
+        const char* p = text;
+        for (; *p; p++) {
+            hash ^= (unsigned char)*p;
+            hash *= 1099511628211ull;
+        }
+        length = (size_t)(p - text);
+        return hash;
+    }
+
+    const Slot& Shape(const char* text, float size) {
+        int atlasIndex = Resolve(size);
+        size_t length = 0;
+        uint64_t hash = Hash(text, length);
+        uint32_t sizeBits;
+        memcpy(&sizeBits, &size, sizeof(sizeBits));
+        Slot& slot = cache[(hash ^ sizeBits ^ (uint64_t)(atlasIndex + 1) * 0x9e3779b9u) & (CACHE_SLOTS - 1)];
+        if (slot.valid && slot.hash == hash && slot.size == size && slot.atlas == atlasIndex &&
+            slot.text.size() == length && memcmp(slot.text.data(), text, length) == 0) {
+            stats.cached++;
+            return slot;
+        }
+        stats.shaped++;
+
+        slot.valid = true;
+        slot.hash = hash;
+        slot.size = size;
+        slot.atlas = atlasIndex;
+        slot.text.assign(text, length);
+        slot.dest.clear();
+        slot.source.clear();
+
+        // Placement as DrawTextEx(): glyph offsets and advances scaled from the atlas size, plus letter spacing
+        Font font;
+        const std::array<int, 128>* lookup = nullptr;
+        float spacing;
+        if (atlasIndex >= 0) {
+            font = atlases[atlasIndex].font;
+            lookup = &atlases[atlasIndex].lookup;
+            spacing = 0.0f;
+        } else {
+            font = GetFontDefault();
+            spacing = (float)((int)std::max(size, (float)DEFAULT_FONT_SIZE) / DEFAULT_FONT_SIZE);
+        }
+        float scale = size / font.baseSize;
+        float padding = (float)font.glyphPadding;
+        slot.texture = font.texture;
+
+        float penX = 0.0f;
+        for (size_t i = 0; i < length; i++) {
+            unsigned char c = (unsigned char)text[i];
+            if (c >= 128) c = '?';
+            int index = lookup ? (*lookup)[c] : GetGlyphIndex(font, c);
+            const GlyphInfo& glyph = font.glyphs[index];
+            const Rectangle& rec = font.recs[index];
+            if (c != ' ' && c != '\t') {
+                slot.source.push_back({rec.x - padding, rec.y - padding, rec.width + 2.0f * padding, rec.height + 2.0f * padding});
+                slot.dest.push_back({penX + (glyph.offsetX - padding) * scale, (glyph.offsetY - padding) * scale,
+                                     (rec.width + 2.0f * padding) * scale, (rec.height + 2.0f * padding) * scale});
+            }
+            float advance = glyph.advanceX != 0 ? glyph.advanceX * scale : rec.width * scale;
+            penX += advance + (i + 1 < length ? spacing : 0.0f);
+        }
+        slot.width = penX;
+        return slot;
+    }
+
+    AssetManager* assets = nullptr;
+    std::string fontPath;
+    bool hasFontFile = false;
+    std::array<Atlas, ATLAS_COUNT> atlases{};
+    std::array<Slot, CACHE_SLOTS> cache{};
+    uint32_t version = 0;
+    Stats stats;
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdio>
+
+// Per-frame arena for formatted UI text.
+//
+// Format() writes into a fixed buffer and returns a pointer that stays valid
+// until the next Reset(), which Game calls at the start of every Draw(). Unlike
+// std::string this never touches the heap, and unlike raylib's TextFormat()
+// (a ring of four static buffers) any number of strings can be alive at once.
+class TextScratch {
+public:
+    static constexpr size_t CAPACITY = 8 * 1024;
+
+    void Reset() { used = 0; }
+
+    // printf-style; when the arena is full the text is truncated (possibly to "")
+    const char* Format(const char* format, ...) {
+        char* out = buffer + used;
+        size_t available = CAPACITY - used;
+        if (available == 0) return "";
+
+        va_list args;
+        va_start(args, format);
+        int written = vsnprintf(out, available, format, args);
+        va_end(args);
+        if (written < 0) {
+            out[0] = '\0';
+            return out;
+        }
+
+        size_t length = (size_t)written < available ? (size_t)written : available - 1;
+        used += length + 1;
+        return out;
+    }
+
+    size_t GetUsed() const { return used; }
+
+private:
+    char buffer[CAPACITY];
+    size_t used = 0;
+};
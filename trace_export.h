@@ -0,0 +1,164 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Records timed spans as Chrome trace events ("X" complete events) and
+// writes them as JSON that chrome://tracing and ui.perfetto.dev open directly.
+//
+// Meant for the rare, expensive moments the frame profiler doesn't cover:
+// startup, shutdown, save I/O and display mode changes. Off unless started,
+// and every call is a single branch while off, so the hooks stay in release
+// builds and a field unit can produce a trace without a rebuild.
+//
+// Thread-safe. Event and thread names must be string literals (or otherwise
+// outlive the recorder); they are stored as pointers and written unescaped.
+class TraceRecorder {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t MAX_EVENTS = 8192; // Later events are counted and dropped
+    static constexpr int MAX_THREADS = 32;
+
+    // Starts recording if variable is set and non-empty. Its value is the
+    // output path, except "1", which writes to defaultPath.
+    bool StartFromEnvironment(const char* variable, const std::string& defaultPath) {
+        const char* value = getenv(variable);
+        if (!value || strlen(value) == 0) return false;
+        outputPath = strcmp(value, "1") == 0 ? defaultPath : std::string(value);
+        origin = Clock::now();
+        events.reserve(MAX_EVENTS);
+        enabled.store(true, std::memory_order_release);
+        printf("[INFO] Recording trace events to %s\n", outputPath.c_str());
+        return true;
+    }
+
+    bool IsEnabled() const { return enabled.load(std::memory_order_acquire); }
+
+    // Names the calling thread in the trace viewer
+    void SetThreadName(const char* name) {
+        if (!IsEnabled()) return;
+        int tid = GetThreadId();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tid < MAX_THREADS) threadNames[tid] = name;
+    }
+
+    // Adds a span that ran on the calling thread from start to end. With a
+    // thread name, the span goes on the thread registered under it instead
+    // (or a new track of that name), for spans timed elsewhere and reported later.
+    void Complete(const char* name, const char* category, Clock::time_point start, Clock::time_point end,
+                  const char* thread = nullptr) {
+        if (!IsEnabled()) return;
+        int tid = thread ? -1 : GetThreadId();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (thread) tid = FindThreadLocked(thread);
+        if (events.size() == MAX_EVENTS) {
+            droppedEvents++;
+            return;
+        }
+        events.push_back({name, category, ToMicros(start), ToMicros(end - start), tid});
+    }
+
+    // Writes everything recorded so far; call once threads that record have stopped
+    bool Write() {
+        if (!IsEnabled()) return false;
+        std::lock_guard<std::mutex> lock(mutex);
+        FILE* file = fopen(outputPath.c_str(), "w");
+        if (!file) {
+            printf("[WARNING] Could not write trace to %s\n", outputPath.c_str());
+            return false;
+        }
+        fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+        bool first = true;
+        for (int tid = 0; tid < MAX_THREADS; tid++) {
+            if (!threadNames[tid]) continue;
+            fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                    first ? "" : ",\n", tid, threadNames[tid]);
+            first = false;
+        }
+        for (const Event& event : events) {
+            fprintf(file, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+                    first ? "" : ",\n", event.name, event.category, event.startUs, event.durationUs, event.tid);
+            first = false;
+        }
+        fprintf(file, "\n]}\n");
+        bool ok = fclose(file) == 0;
+        printf("[INFO] Wrote %zu trace events to %s", events.size(), outputPath.c_str());
+        if (droppedEvents > 0) printf(" (%zu dropped)", droppedEvents);
+        printf("\n");
+        return ok;
+    }
+
+private:
+    struct Event {
+        const char* name;
+        const char* category;
+        double startUs;
+        double durationUs;
+        int tid;
+    };
+
+    // Small sequential ids read better in the viewer than OS thread ids
+    int GetThreadId() {
+        thread_local int tid = -1;
+        if (tid < 0) tid = nextThreadId.fetch_add(1, std::memory_order_relaxed);
+        return tid;
+    }
+
+    int FindThreadLocked(const char* thread) {
+        for (int tid = 0; tid < MAX_THREADS; tid++) {
+            if (threadNames[tid] && strcmp(threadNames[tid], thread) == 0) return tid;
+        }
+        int tid = nextThreadId.fetch_add(1, std::memory_order_relaxed);
+        if (tid < MAX_THREADS) threadNames[tid] = thread;
+        return tid;
+    }
+
+    double ToMicros(Clock::duration duration) const {
+        return std::chrono::duration<double, std::micro>(duration).count();
+    }
+    double ToMicros(Clock::time_point time) const { return ToMicros(time - origin); }
+
+    std::atomic<bool> enabled{false};
+    std::string outputPath;
+    Clock::time_point origin;
+
+    std::mutex mutex;
+    std::vector<Event> events; // Guarded by mutex; capacity fixed at start
+    size_t droppedEvents = 0;  // Guarded by mutex
+
+    std::atomic<int> nextThreadId{0};
+    std::array<const char*, MAX_THREADS> threadNames{}; // Guarded by mutex
+};
+
+// Records the enclosing scope as one trace event
+class TraceScope {
+public:
+    TraceScope(TraceRecorder& recorder, const char* name, const char* category)
+        : recorder(recorder), name(name), category(category) {
+        if (recorder.IsEnabled()) start = TraceRecorder::Clock::now();
+    }
+    ~TraceScope() {
+        if (recorder.IsEnabled()) recorder.Complete(name, category, start, TraceRecorder::Clock::now());
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    TraceRecorder& recorder;
+    const char* name;
+    const char* category;
+    TraceRecorder::Clock::time_point start;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(recorder, name, category) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(recorder, name, category)
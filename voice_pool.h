@@ -0,0 +1,152 @@
+#pragma once
+
+#include "raylib.h"
+#include <array>
+
+// Plays short UI sounds through a fixed set of voices.
+//
+// Calling PlaySound() on a playing Sound restarts it, so rapid clicks cut
+// each other off mid-sample. Instead each source sound gets up to
+// VOICES_PER_SOUND aliases (LoadSoundAlias shares the sample data, so a voice
+// costs only a mixer slot), and a new play takes a free one. When every alias
+// of that sound is busy, or MAX_VOICES are already playing in total, the
+// voice that has played longest is stopped and reused; it is the quietest
+// point to cut.
+//
+// Plays of the same sound closer together than its cooldown are merged into
+// the first one, so a burst (key repeat, a save click right after an adjust
+// click) costs one voice instead of a pile of overlapping starts.
+//
+// Main thread only. Call ReleaseSound() before unloading a source that has
+// been played, and Shutdown() before closing the audio device.
+class VoicePool {
+public:
+    static constexpr int MAX_VOICES = 8;          // Mixer-side cap on voices playing at once
+    static constexpr int VOICES_PER_SOUND = 4;
+    static constexpr double DEFAULT_COOLDOWN = 0.05; // Seconds
+
+    // Plays source on a pooled voice; returns false if it was coalesced or source isn't loaded
+    bool Play(Sound source, float volume = 1.0f, double cooldown = DEFAULT_COOLDOWN) {
+        if (source.stream.buffer == nullptr || source.frameCount == 0) return false;
+        double now = GetTime();
+
+        Source* entry = FindSource(source);
+        if (!entry) return false;
+        if (entry->lastPlay >= 0.0 && now - entry->lastPlay < cooldown) {
+            coalescedPlays++;
+            return false;
+        }
+
+        Voice* voice = PickVoice(*entry);
+        if (!voice) return false;
+        if (IsSoundPlaying(voice->sound)) {
+            StopSound(voice->sound);
+            stolenVoices++;
+        }
+        SetSoundVolume(voice->sound, volume);
+        PlaySound(voice->sound);
+        voice->startTime = now;
+        entry->lastPlay = now;
+        return true;
+    }
+
+    // Stops and frees every voice of source; call before unloading it
+    void ReleaseSound(Sound source) {
+        for (Source& entry : sources) {
+            if (entry.buffer != source.stream.buffer) continue;
+            for (Voice& voice : entry.voices) {
+                if (voice.loaded) UnloadSoundAlias(voice.sound);
+                voice = Voice();
+            }
+            entry = Source();
+        }
+    }
+
+    void Shutdown() {
+        for (Source& entry : sources) {
+            for (Voice& voice : entry.voices) {
+                if (voice.loaded) UnloadSoundAlias(voice.sound);
+                voice = Voice();
+            }
+            entry = Source();
+        }
+    }
+
+    int GetPlayingCount() const {
+        int playing = 0;
+        for (const Source& entry : sources) {
+            for (const Voice& voice : entry.voices) playing += voice.loaded && IsSoundPlaying(voice.sound);
+        }
+        return playing;
+    }
+
+    // Plays merged by the cooldown and voices cut short for a new play, since startup
+    int GetCoalescedPlays() const { return coalescedPlays; }
+    int GetStolenVoices() const { return stolenVoices; }
+
+private:
+    static constexpr int MAX_SOURCES = 8;
+
+    struct Voice {
+        Sound sound = {};
+        bool loaded = false;
+        double startTime = 0.0;
+    };
+
+    struct Source {
+        const void* buffer = nullptr; // Identifies the source Sound; null = slot unused
+        Sound sound = {};
+        std::array<Voice, VOICES_PER_SOUND> voices;
+        double lastPlay = -1.0;
+    };
+
+    Source* FindSource(Sound source) {
+        Source* freeSlot = nullptr;
+        for (Source& entry : sources) {
+            if (entry.buffer == source.stream.buffer) return &entry;
+            if (!entry.buffer && !freeSlot) freeSlot = &entry;
+        }
+        if (freeSlot) {
+            freeSlot->buffer = source.stream.buffer;
+            freeSlot->sound = source;
+        }
+        return freeSlot;
+    }
+
+    // A free voice of this sound, else the longest-playing one for Play() to steal
+    Voice* PickVoice(Source& entry) {
+        if (GetPlayingCount() >= MAX_VOICES) StopOldestOverall();
+
+        Voice* oldest = nullptr;
+        for (Voice& voice : entry.voices) {
+            if (!voice.loaded) {
+                voice.sound = LoadSoundAlias(entry.sound);
+                voice.loaded = true;
+                return &voice;
+            }
+            if (!IsSoundPlaying(voice.sound)) return &voice;
+            if (!oldest || voice.startTime < oldest->startTime) oldest = &voice;
+        }
+        return oldest;
+    }
+
+    // At the global cap: stop whatever has played longest to make room
+    void StopOldestOverall() {
+        Voice* oldest = nullptr;
+        for (Source& entry : sources) {
+            for (Voice& voice : entry.voices) {
+                if (voice.loaded && IsSoundPlaying(voice.sound) && (!oldest || voice.startTime < oldest->startTime)) {
+                    oldest = &voice;
+                }
+            }
+        }
+        if (oldest) {
+            StopSound(oldest->sound);
+            stolenVoices++;
+        }
+    }
+
+    std::array<Source, MAX_SOURCES> sources;
+    int coalescedPlays = 0;
+    int stolenVoices = 0;
+};